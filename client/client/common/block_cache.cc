@@ -25,6 +25,8 @@
 
 #include <iostream>
 
+#include "common/crail_constants.h"
+
 using namespace std;
 
 BlockCache::BlockCache(int fd) : fd_(fd) {}
@@ -32,15 +34,30 @@ BlockCache::BlockCache(int fd) : fd_(fd) {}
 BlockCache::~BlockCache() {}
 
 int BlockCache::PutBlock(long long offset, shared_ptr<BlockInfo> block) {
-  cache_.insert({offset, block});
+  if (offset < 0) {
+    return -1;
+  }
+
+  unsigned long long index = offset / kBlockSize;
+  lock_guard<mutex> guard(lock_);
+  if (index >= blocks_.size()) {
+    blocks_.resize(index + 1);
+  }
+  if (!blocks_[index]) {
+    blocks_[index] = block;
+  }
   return 0;
 }
 
 shared_ptr<BlockInfo> BlockCache::GetBlock(long long offset) {
-  shared_ptr<BlockInfo> block = nullptr;
-  auto iter = cache_.find(offset);
-  if (iter != cache_.end()) {
-    block = iter->second;
+  if (offset < 0) {
+    return nullptr;
+  }
+
+  unsigned long long index = offset / kBlockSize;
+  lock_guard<mutex> guard(lock_);
+  if (index >= blocks_.size()) {
+    return nullptr;
   }
-  return block;
+  return blocks_[index];
 }
@@ -25,7 +25,8 @@
 #define BLOCK_CACHE_H
 
 #include "metadata/block_info.h"
-#include <unordered_map>
+#include <mutex>
+#include <vector>
 
 using namespace std;
 using namespace crail;
@@ -38,9 +39,13 @@ public:
   int PutBlock(long long offset, shared_ptr<BlockInfo> block);
   shared_ptr<BlockInfo> GetBlock(long long offset);
 
+  int fd() const { return fd_; }
+
 private:
   int fd_;
-  unordered_map<long long, shared_ptr<BlockInfo>> cache_;
+  mutex lock_;
+  // indexed by block number, any offset within a block finds it
+  vector<shared_ptr<BlockInfo>> blocks_;
 };
 
 #endif /* BLOCK_CACHE_H */
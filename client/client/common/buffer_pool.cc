@@ -0,0 +1,131 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "buffer_pool.h"
+
+#include <sys/mman.h>
+
+#include "common/pool_allocator.h"
+
+namespace {
+const long long kHugePageSize = 2 * 1024 * 1024;
+
+class PooledBuffer : public ByteBuffer {
+public:
+  PooledBuffer(BufferPool *pool, unsigned char *data, int size, int size_class)
+      : ByteBuffer(data, size), pool_(pool), data_(data),
+        size_class_(size_class) {}
+  virtual ~PooledBuffer() { pool_->Release(data_, size(), size_class_); }
+
+private:
+  BufferPool *pool_;
+  unsigned char *data_;
+  int size_class_;
+};
+} // namespace
+
+BufferPool &BufferPool::Instance() {
+  // never destroyed, buffers may be released during static destruction
+  static BufferPool *pool = new BufferPool();
+  return *pool;
+}
+
+BufferPool::BufferPool() : cached_(0), hugetlb_(false) {}
+
+BufferPool::~BufferPool() {}
+
+shared_ptr<ByteBuffer> BufferPool::Get(int size) {
+  int size_class = SizeClass(size);
+  unsigned char *data = nullptr;
+  if (size_class < kBufferClasses) {
+    lock_guard<mutex> guard(lock_);
+    vector<unsigned char *> &list = free_[size_class];
+    if (!list.empty()) {
+      data = list.back();
+      list.pop_back();
+      cached_ -= ClassSize(size_class);
+    }
+  }
+  if (!data) {
+    long long length =
+        size_class < kBufferClasses ? ClassSize(size_class) : size;
+    data = Map(length);
+    if (!data) {
+      return nullptr;
+    }
+  }
+  return MakePooled<PooledBuffer>(this, data, size, size_class);
+}
+
+void BufferPool::Release(unsigned char *data, int size, int size_class) {
+  if (size_class >= kBufferClasses) {
+    Unmap(data, size);
+    return;
+  }
+
+  long long length = ClassSize(size_class);
+  {
+    lock_guard<mutex> guard(lock_);
+    if (cached_ + length <= kBufferPoolCache) {
+      free_[size_class].push_back(data);
+      cached_ += length;
+      return;
+    }
+  }
+  Unmap(data, length);
+}
+
+int BufferPool::SizeClass(int size) const {
+  int size_class = 0;
+  while (size_class < kBufferClasses && ClassSize(size_class) < size) {
+    size_class++;
+  }
+  return size_class;
+}
+
+long long BufferPool::ClassSize(int size_class) const {
+  return 1LL << (kMinBufferShift + size_class);
+}
+
+unsigned char *BufferPool::Map(long long length) {
+  void *data = MAP_FAILED;
+  if (length >= kHugePageSize && length % kHugePageSize == 0 && hugetlb_) {
+    data = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+  if (data == MAP_FAILED) {
+    data = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      return nullptr;
+    }
+    if (length >= kHugePageSize) {
+      madvise(data, length, MADV_HUGEPAGE);
+    }
+  }
+  return (unsigned char *)data;
+}
+
+void BufferPool::Unmap(unsigned char *data, long long length) {
+  munmap(data, length);
+}
@@ -0,0 +1,74 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/byte_buffer.h"
+
+using namespace std;
+using namespace crail;
+
+// smallest pooled buffer is 4KB, the largest 64MB
+const int kMinBufferShift = 12;
+const int kBufferClasses = 15;
+// bytes of released buffers the pool keeps for reuse
+const long long kBufferPoolCache = 256LL * 1024 * 1024;
+
+// Process wide pool of mmap'ed buffers in power of two size classes.
+// Buffers are handed out as ByteBuffer views that return their memory to
+// the pool when the last reference goes away. Memory is not zeroed.
+// Classes of 2MB and up are backed by hugepages, MAP_HUGETLB if enabled
+// and reserved, transparent hugepages otherwise.
+class BufferPool {
+public:
+  static BufferPool &Instance();
+
+  shared_ptr<ByteBuffer> Get(int size);
+  void Release(unsigned char *data, int size, int size_class);
+
+  void set_hugetlb(bool hugetlb) { this->hugetlb_ = hugetlb; }
+  bool hugetlb() const { return hugetlb_; }
+  long long cached() const { return cached_; }
+
+private:
+  BufferPool();
+  virtual ~BufferPool();
+
+  int SizeClass(int size) const;
+  long long ClassSize(int size_class) const;
+  unsigned char *Map(long long length);
+  void Unmap(unsigned char *data, long long length);
+
+  mutex lock_;
+  vector<unsigned char *> free_[kBufferClasses];
+  atomic<long long> cached_;
+  atomic<bool> hugetlb_;
+};
+
+#endif /* BUFFER_POOL_H */
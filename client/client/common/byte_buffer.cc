@@ -33,6 +33,7 @@ using namespace std;
 
 ByteBuffer::ByteBuffer(int size) {
   this->buf_ = new unsigned char[size];
+  this->owner_ = true;
   this->size_ = size;
   this->limit_ = size;
   this->position_ = 0;
@@ -40,7 +41,20 @@ ByteBuffer::ByteBuffer(int size) {
   Zero();
 }
 
-ByteBuffer::~ByteBuffer() { delete[] buf_; }
+ByteBuffer::ByteBuffer(unsigned char *data, int size) {
+  this->buf_ = data;
+  this->owner_ = false;
+  this->size_ = size;
+  this->limit_ = size;
+  this->position_ = 0;
+  this->order_ = ByteOrder::BigEndian;
+}
+
+ByteBuffer::~ByteBuffer() {
+  if (owner_) {
+    delete[] buf_;
+  }
+}
 
 void ByteBuffer::PutByte(unsigned char value) {
   unsigned char *_tmp = (unsigned char *)get_bytes();
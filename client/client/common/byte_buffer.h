@@ -35,6 +35,8 @@ enum class ByteOrder : short { BigEndian = 1, LittleEndian = 2 };
 class ByteBuffer {
 public:
   ByteBuffer(int size);
+  // non-owning view on memory that outlives the buffer, not zeroed
+  ByteBuffer(unsigned char *data, int size);
   virtual ~ByteBuffer();
 
   void PutByte(unsigned char value);
@@ -78,6 +80,7 @@ private:
   int position_;
   int limit_;
   unsigned char *buf_;
+  bool owner_;
 
   ByteOrder order_;
 };
@@ -0,0 +1,117 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "client_stats.h"
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+using namespace std::chrono;
+
+namespace {
+const char *kStatNames[] = {
+    "namenode_create",   "namenode_lookup", "namenode_getblock",
+    "namenode_getblockrange", "namenode_setfile", "namenode_remove",
+    "namenode_ioctl",    "storage_read",    "storage_write",
+    "store_create",      "store_lookup",    "store_remove",
+    "stream_read",       "stream_write",    "stream_close",
+    "put",               "get",
+};
+static_assert(sizeof(kStatNames) / sizeof(kStatNames[0]) ==
+                  static_cast<int>(Stat::Count),
+              "a name per stat");
+}
+
+ClientStats &ClientStats::Instance() {
+  // leaked, other static destructors may still record
+  static ClientStats *instance = new ClientStats();
+  return *instance;
+}
+
+unsigned long long ClientStats::Now() {
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
+ClientStats::ClientStats() { Reset(); }
+
+ClientStats::~ClientStats() {}
+
+void ClientStats::Record(Stat stat, unsigned long long start,
+                         unsigned long long bytes) {
+  int index = static_cast<int>(stat);
+  latency_[index].Record(Now() - start);
+  if (bytes > 0) {
+    bytes_[index].fetch_add(bytes, memory_order_relaxed);
+  }
+}
+
+void ClientStats::Snapshot(vector<StatSummary> &summaries) const {
+  for (int i = 0; i < static_cast<int>(Stat::Count); i++) {
+    const Histogram &latency = latency_[i];
+    StatSummary summary;
+    summary.name = kStatNames[i];
+    summary.count = latency.count();
+    summary.bytes = bytes_[i];
+    summary.mean = summary.count ? latency.sum() / summary.count : 0;
+    summary.p50 = latency.Percentile(0.5);
+    summary.p99 = latency.Percentile(0.99);
+    summary.p999 = latency.Percentile(0.999);
+    summary.max = latency.max();
+    summaries.push_back(summary);
+  }
+}
+
+string ClientStats::Dump() const {
+  vector<StatSummary> summaries;
+  Snapshot(summaries);
+  stringstream out;
+  out << left << setw(24) << "op" << right << setw(10) << "count"
+      << setw(14) << "bytes" << setw(10) << "mean[us]" << setw(10)
+      << "p50[us]" << setw(10) << "p99[us]" << setw(10) << "p999[us]"
+      << setw(10) << "max[us]" << endl;
+  out << fixed << setprecision(1);
+  for (StatSummary &summary : summaries) {
+    if (summary.count == 0) {
+      continue;
+    }
+    out << left << setw(24) << summary.name << right << setw(10)
+        << summary.count << setw(14) << summary.bytes << setw(10)
+        << summary.mean / 1000.0 << setw(10) << summary.p50 / 1000.0
+        << setw(10) << summary.p99 / 1000.0 << setw(10)
+        << summary.p999 / 1000.0 << setw(10) << summary.max / 1000.0 << endl;
+  }
+  return out.str();
+}
+
+void ClientStats::Reset() {
+  for (int i = 0; i < static_cast<int>(Stat::Count); i++) {
+    latency_[i].Reset();
+    bytes_[i] = 0;
+  }
+}
+
+const char *ClientStats::Name(Stat stat) {
+  return kStatNames[static_cast<int>(stat)];
+}
@@ -0,0 +1,106 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CLIENT_STATS_H
+#define CLIENT_STATS_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "utils/histogram.h"
+
+using namespace std;
+
+// Operations the client measures. Namenode and storage entries time single
+// RPCs from issue to reply, the others whole client calls.
+enum class Stat {
+  NamenodeCreate = 0,
+  NamenodeLookup,
+  NamenodeGetBlock,
+  NamenodeGetBlockRange,
+  NamenodeSetFile,
+  NamenodeRemove,
+  NamenodeIoctl,
+  StorageRead,
+  StorageWrite,
+  StoreCreate,
+  StoreLookup,
+  StoreRemove,
+  StreamRead,
+  StreamWrite,
+  StreamClose,
+  Put,
+  Get,
+  Count,
+};
+
+struct StatSummary {
+  string name;
+  unsigned long long count;
+  unsigned long long bytes;
+  // latencies in nanoseconds
+  unsigned long long mean;
+  unsigned long long p50;
+  unsigned long long p99;
+  unsigned long long p999;
+  unsigned long long max;
+};
+
+// Process wide latency histograms and byte counters per operation, always
+// on. Recording is lock-free.
+class ClientStats {
+public:
+  static ClientStats &Instance();
+  static unsigned long long Now();
+
+  void Record(Stat stat, unsigned long long start, unsigned long long bytes);
+  void Snapshot(vector<StatSummary> &summaries) const;
+  string Dump() const;
+  void Reset();
+
+  static const char *Name(Stat stat);
+
+private:
+  ClientStats();
+  virtual ~ClientStats();
+
+  Histogram latency_[static_cast<int>(Stat::Count)];
+  atomic<unsigned long long> bytes_[static_cast<int>(Stat::Count)];
+};
+
+// records the time from construction to destruction
+class StatTimer {
+public:
+  StatTimer(Stat stat) : stat_(stat), start_(ClientStats::Now()), bytes_(0) {}
+  ~StatTimer() { ClientStats::Instance().Record(stat_, start_, bytes_); }
+
+  void set_bytes(unsigned long long bytes) { this->bytes_ = bytes; }
+
+private:
+  Stat stat_;
+  unsigned long long start_;
+  unsigned long long bytes_;
+};
+
+#endif /* CLIENT_STATS_H */
@@ -36,6 +36,43 @@ const int kBlockSize = 65536; //4096;
 // const int kBlockSize = 4096;
 //const int kBufferSize = 1048576;
 const int kBufferSize = 524288;
+// size of a record slot in a directory file
+const int kDirectoryRecord = 512;
+// number of block writes an outputstream keeps in flight
+const int kWriteWindow = 8;
+// number of blocks an inputstream reads ahead of the caller
+const int kReadAhead = 4;
+// microseconds a client spins on a socket before blocking in epoll
+const int kSpinTime = 50;
+// whether stores receive through a per-thread io_uring instead of epoll
+const bool kIoRing = false;
+// submission queue depth of a per-thread io_uring
+const int kRingEntries = 8;
+// lock shards of the client side caches shared by all threads of a store
+const int kCacheShards = 16;
+// upper bound on connections a store opens to a single datanode
+const int kPoolSize = 1;
+// deferred SetFile updates a store sends to the namenode in one message
+const int kCloseBatch = 16;
+// milliseconds a store trusts a lookup result, 0 disables the cache
+const int kLookupTtl = 0;
+// milliseconds a store remembers a name the namenode did not find
+const int kNegativeTtl = 0;
+// upper bound on names held by the lookup cache of a store
+const int kMetadataCacheSize = 65536;
+// upper bound on files whose block locations a store caches
+const int kBlockCacheFiles = 4096;
+// parent directories whose component hashes each thread remembers
+const int kPathHashEntries = 8;
+// whether stores ask the namenode for the compact filename encoding
+const bool kCompactFilename = true;
+// namenode protocol versions, sent in the high byte of a request type
+const short kProtocolLegacy = 0;
+const short kProtocolCompactFilename = 1;
+// ping op answered with op + 1 + version, older namenodes reply op + 1
+const int kPingProtocolProbe = 0x50434b00;
+// namenode error returned for a lookup of a missing name
+const int kErrGetFileFailed = 4;
 } // namespace crail
 
 #endif /* CRAIL_CONSTANTS_H */
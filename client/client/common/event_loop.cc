@@ -0,0 +1,109 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "event_loop.h"
+
+#include <chrono>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "common/crail_constants.h"
+
+using namespace std::chrono;
+using namespace crail;
+
+namespace {
+const int kMaxEvents = 64;
+}
+
+EventLoop::EventLoop()
+    : spin_time_(kSpinTime), io_ring_(kIoRing), polling_(false) {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+}
+
+EventLoop::~EventLoop() {
+  if (epoll_fd_ >= 0) {
+    close(epoll_fd_);
+  }
+}
+
+int EventLoop::Register(int fd) {
+  lock_guard<mutex> guard(lock_);
+  return RegisterLocked(fd);
+}
+
+int EventLoop::RegisterLocked(int fd) {
+  if (registered_.count(fd) > 0) {
+    return 0;
+  }
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLET;
+  event.data.fd = fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    return -1;
+  }
+  registered_.insert(fd);
+  return 0;
+}
+
+int EventLoop::Unregister(int fd) {
+  lock_guard<mutex> guard(lock_);
+  ready_.erase(fd);
+  if (registered_.erase(fd) == 0) {
+    return 0;
+  }
+  return epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int EventLoop::WaitReadable(int fd) {
+  unique_lock<mutex> lock(lock_);
+  if (registered_.count(fd) == 0 && RegisterLocked(fd) < 0) {
+    return -1;
+  }
+
+  auto deadline = steady_clock::now() + microseconds(spin_time_);
+  while (ready_.erase(fd) == 0) {
+    if (polling_) {
+      ready_cv_.wait(lock);
+      continue;
+    }
+
+    int timeout = steady_clock::now() < deadline ? 0 : -1;
+    polling_ = true;
+    lock.unlock();
+    struct epoll_event events[kMaxEvents];
+    int count = epoll_wait(epoll_fd_, events, kMaxEvents, timeout);
+    int error = errno;
+    lock.lock();
+    polling_ = false;
+    for (int i = 0; i < count; i++) {
+      ready_.insert(events[i].data.fd);
+    }
+    ready_cv_.notify_all();
+    if (count < 0 && error != EINTR) {
+      return -1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_set>
+
+using namespace std;
+
+// One edge-triggered epoll set for all sockets of a store. Waiting for a
+// socket spins for spin_time microseconds and then blocks in the kernel,
+// readiness of other sockets seen along the way is kept for their next wait.
+// Only one thread calls epoll_wait at a time, the others sleep on ready_cv_
+// until the poller hands out what it found.
+class EventLoop {
+public:
+  EventLoop();
+  virtual ~EventLoop();
+
+  int Register(int fd);
+  int Unregister(int fd);
+  int WaitReadable(int fd);
+
+  void set_spin_time(int spin_time) { this->spin_time_ = spin_time; }
+  int spin_time() const { return spin_time_; }
+  // receives that would block wait in the calling thread's io_uring, where
+  // the kernel supports it, instead of spinning and polling
+  void set_io_ring(bool io_ring) { this->io_ring_ = io_ring; }
+  bool io_ring() const { return io_ring_; }
+
+private:
+  int RegisterLocked(int fd);
+
+  int epoll_fd_;
+  atomic<int> spin_time_;
+  atomic<bool> io_ring_;
+  mutex lock_;
+  condition_variable ready_cv_;
+  bool polling_;
+  unordered_set<int> registered_;
+  unordered_set<int> ready_;
+};
+
+#endif /* EVENT_LOOP_H */
@@ -0,0 +1,44 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "future_group.h"
+
+FutureGroup::FutureGroup() : res_(0) {}
+
+FutureGroup::~FutureGroup() {}
+
+void FutureGroup::Add(shared_ptr<Future> future, shared_ptr<ByteBuffer> buffer) {
+  futures_.push_back(future);
+  buffers_.push_back(buffer);
+}
+
+int FutureGroup::Get() {
+  for (shared_ptr<Future> &future : futures_) {
+    if (future->Get() < 0) {
+      res_ = -1;
+    }
+  }
+  futures_.clear();
+  buffers_.clear();
+  return res_;
+}
@@ -0,0 +1,54 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FUTURE_GROUP_H
+#define FUTURE_GROUP_H
+
+#include <memory>
+#include <vector>
+
+#include "common/byte_buffer.h"
+#include "common/future.h"
+
+using namespace std;
+using namespace crail;
+
+// Completes once every future added to it has completed, keeps the
+// buffers the operations read into or write from alive until then.
+class FutureGroup : public Future {
+public:
+  FutureGroup();
+  virtual ~FutureGroup();
+
+  void Add(shared_ptr<Future> future, shared_ptr<ByteBuffer> buffer);
+  int Get();
+
+  int size() const { return futures_.size(); }
+
+private:
+  vector<shared_ptr<Future>> futures_;
+  vector<shared_ptr<ByteBuffer>> buffers_;
+  int res_;
+};
+
+#endif /* FUTURE_GROUP_H */
@@ -0,0 +1,239 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io_ring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "common/crail_constants.h"
+
+using namespace crail;
+
+IoRing::IoRing()
+    : ring_fd_(-1), broken_(false), sq_ring_(MAP_FAILED), sq_ring_size_(0),
+      cq_ring_(MAP_FAILED), cq_ring_size_(0), sqes_(nullptr), sqes_size_(0) {}
+
+IoRing::~IoRing() {
+  if (sqes_) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != MAP_FAILED) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+int IoRing::Initialize(unsigned entries) {
+#ifdef __NR_io_uring_setup
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = syscall(__NR_io_uring_setup, entries, &params);
+  if (ring_fd_ < 0) {
+    return -1;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap && cq_ring_size_ > sq_ring_size_) {
+    sq_ring_size_ = cq_ring_size_;
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    return -1;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      return -1;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return -1;
+  }
+  sqes_ = (struct io_uring_sqe *)sqes;
+
+  char *sq = (char *)sq_ring_;
+  sq_head_ = (unsigned *)(sq + params.sq_off.head);
+  sq_tail_ = (unsigned *)(sq + params.sq_off.tail);
+  sq_mask_ = (unsigned *)(sq + params.sq_off.ring_mask);
+  sq_array_ = (unsigned *)(sq + params.sq_off.array);
+  char *cq = (char *)cq_ring_;
+  cq_head_ = (unsigned *)(cq + params.cq_off.head);
+  cq_tail_ = (unsigned *)(cq + params.cq_off.tail);
+  cq_mask_ = (unsigned *)(cq + params.cq_off.ring_mask);
+  cqes_ = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+int IoRing::RecvMsg(int fd, struct msghdr *msg, int flags) {
+  struct io_uring_sqe op;
+  memset(&op, 0, sizeof(op));
+  op.opcode = IORING_OP_RECVMSG;
+  op.fd = fd;
+  op.addr = (unsigned long long)msg;
+  op.len = 1;
+  op.msg_flags = flags;
+  return Complete(op);
+}
+
+int IoRing::Complete(struct io_uring_sqe &op) {
+  if (broken_) {
+    errno = ENOSYS;
+    return -1;
+  }
+
+  // the ring is private to its thread, exactly one operation is in flight
+  op.user_data = kOpData;
+  unsigned tail = Push(op);
+
+  unsigned submit = 1;
+  for (;;) {
+    int res;
+    if (Reap(kOpData, res)) {
+      if (res == -EINVAL || res == -EOPNOTSUPP) {
+        // the opcode is too new for this kernel
+        broken_ = true;
+      }
+      if (res < 0) {
+        errno = -res;
+        return -1;
+      }
+      return res;
+    }
+
+    int entered = syscall(__NR_io_uring_enter, ring_fd_, submit, 1,
+                          IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (entered < 0 && errno != EINTR) {
+      int error = errno;
+      broken_ = true;
+      if (__atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) != tail) {
+        // the kernel has the operation, it must not outlive this call
+        return Abandon(op.fd, error);
+      }
+      errno = error;
+      return -1;
+    }
+    if (__atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) != tail) {
+      submit = 0;
+    }
+  }
+}
+
+int IoRing::Abandon(int fd, int error) {
+  // a pending receive would take bytes from the stream and write them into
+  // iovecs of a caller that has moved on, it is cancelled and reaped first
+  struct io_uring_sqe cancel;
+  memset(&cancel, 0, sizeof(cancel));
+  cancel.opcode = IORING_OP_ASYNC_CANCEL;
+  cancel.fd = -1;
+  cancel.addr = kOpData;
+  cancel.user_data = kCancelData;
+  unsigned tail = Push(cancel);
+
+  unsigned submit = 1;
+  for (int failures = 0; failures < kCancelAttempts;) {
+    int res;
+    if (Reap(kOpData, res)) {
+      // a receive that won the race completed into buffers still in scope
+      if (res >= 0) {
+        return res;
+      }
+      errno = error;
+      return -1;
+    }
+    int entered = syscall(__NR_io_uring_enter, ring_fd_, submit, 1,
+                          IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (entered < 0 && errno != EINTR) {
+      failures++;
+    }
+    if (__atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) != tail) {
+      submit = 0;
+    }
+  }
+
+  // the receive could not be reaped, the connection is failed so that it
+  // can neither take data nor be read from again
+  shutdown(fd, SHUT_RDWR);
+  errno = error;
+  return -1;
+}
+
+unsigned IoRing::Push(const struct io_uring_sqe &op) {
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  sqes_[index] = op;
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  return tail;
+}
+
+bool IoRing::Reap(unsigned long long user_data, int &res) {
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  bool found = false;
+  for (; head != tail; head++) {
+    struct io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+    if (cqe.user_data == user_data) {
+      res = cqe.res;
+      found = true;
+    }
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  return found;
+}
+
+IoRing *IoRing::ThreadRing() {
+  thread_local IoRing ring;
+  thread_local bool initialized = false;
+  thread_local bool available = false;
+  if (!initialized) {
+    initialized = true;
+    available = ring.Initialize(kRingEntries) == 0;
+  }
+  if (!available || ring.broken_) {
+    return nullptr;
+  }
+  return &ring;
+}
@@ -0,0 +1,74 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IO_RING_H
+#define IO_RING_H
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+// Minimal io_uring driven through the raw syscalls, one per thread. An
+// operation is submitted and waited for with a single io_uring_enter, so a
+// receive that has to wait costs one syscall instead of epoll_wait plus
+// recvmsg. Kernels without io_uring (or without IORING_OP_RECVMSG) make
+// ThreadRing return nullptr and callers keep using epoll.
+class IoRing {
+public:
+  IoRing();
+  virtual ~IoRing();
+
+  int Initialize(unsigned entries);
+  int RecvMsg(int fd, struct msghdr *msg, int flags);
+
+  // the calling thread's ring, nullptr if io_uring is unavailable
+  static IoRing *ThreadRing();
+
+private:
+  static const unsigned long long kOpData = 1;
+  static const unsigned long long kCancelData = 2;
+  static const int kCancelAttempts = 16;
+
+  int Complete(struct io_uring_sqe &op);
+  int Abandon(int fd, int error);
+  unsigned Push(const struct io_uring_sqe &op);
+  bool Reap(unsigned long long user_data, int &res);
+
+  int ring_fd_;
+  bool broken_;
+  void *sq_ring_;
+  size_t sq_ring_size_;
+  void *cq_ring_;
+  size_t cq_ring_size_;
+  struct io_uring_sqe *sqes_;
+  size_t sqes_size_;
+  unsigned *sq_head_;
+  unsigned *sq_tail_;
+  unsigned *sq_mask_;
+  unsigned *sq_array_;
+  unsigned *cq_head_;
+  unsigned *cq_tail_;
+  unsigned *cq_mask_;
+  struct io_uring_cqe *cqes_;
+};
+
+#endif /* IO_RING_H */
@@ -0,0 +1,129 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "metadata_cache.h"
+
+#include "common/pool_allocator.h"
+
+using namespace std;
+
+MetadataCache::MetadataCache() : ttl_(kLookupTtl), negative_ttl_(kNegativeTtl) {}
+
+MetadataCache::~MetadataCache() {}
+
+int MetadataCache::Get(const string &name, shared_ptr<FileInfo> &file_info,
+                       shared_ptr<BlockInfo> &block_info) {
+  if (ttl_ == 0 && negative_ttl_ == 0) {
+    return -1;
+  }
+
+  Shard &shard = GetShard(name);
+  lock_guard<mutex> guard(shard.lock);
+  auto iter = shard.entries.find(name);
+  if (iter == shard.entries.end()) {
+    return -1;
+  }
+  Entry &entry = iter->second;
+  if (entry.expiry <= chrono::steady_clock::now()) {
+    shard.entries.erase(iter);
+    return -1;
+  }
+  if (!entry.file_info) {
+    return 0;
+  }
+
+  // callers may update the capacity of the file they are handed
+  file_info = MakePooled<FileInfo>(*entry.file_info);
+  block_info = entry.block_info;
+  return 1;
+}
+
+void MetadataCache::Put(const string &name, shared_ptr<FileInfo> file_info,
+                        shared_ptr<BlockInfo> block_info) {
+  if (ttl_ > 0) {
+    Insert(name, MakePooled<FileInfo>(*file_info), block_info, ttl_);
+  }
+}
+
+void MetadataCache::PutMissing(const string &name) {
+  if (negative_ttl_ > 0) {
+    Insert(name, nullptr, nullptr, negative_ttl_);
+  }
+}
+
+void MetadataCache::Invalidate(const string &name, bool recursive) {
+  if (ttl_ == 0 && negative_ttl_ == 0) {
+    return;
+  }
+
+  if (!recursive) {
+    Shard &shard = GetShard(name);
+    lock_guard<mutex> guard(shard.lock);
+    shard.entries.erase(name);
+    return;
+  }
+
+  // children hash to any shard
+  string prefix = name + "/";
+  for (Shard &shard : shards_) {
+    lock_guard<mutex> guard(shard.lock);
+    for (auto iter = shard.entries.begin(); iter != shard.entries.end();) {
+      if (iter->first == name ||
+          iter->first.compare(0, prefix.size(), prefix) == 0) {
+        iter = shard.entries.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+}
+
+void MetadataCache::Insert(const string &name, shared_ptr<FileInfo> file_info,
+                           shared_ptr<BlockInfo> block_info, int ttl) {
+  chrono::steady_clock::time_point now = chrono::steady_clock::now();
+  Shard &shard = GetShard(name);
+  lock_guard<mutex> guard(shard.lock);
+
+  // a full shard first sheds its expired entries, then everything
+  if ((int)shard.entries.size() >= kMetadataCacheSize / kCacheShards) {
+    for (auto iter = shard.entries.begin(); iter != shard.entries.end();) {
+      if (iter->second.expiry <= now) {
+        iter = shard.entries.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+    if ((int)shard.entries.size() >= kMetadataCacheSize / kCacheShards) {
+      shard.entries.clear();
+    }
+  }
+
+  Entry &entry = shard.entries[name];
+  entry.file_info = file_info;
+  entry.block_info = block_info;
+  entry.expiry = now + chrono::milliseconds(ttl);
+}
+
+MetadataCache::Shard &MetadataCache::GetShard(const string &name) {
+  return shards_[hash<string>()(name) % kCacheShards];
+}
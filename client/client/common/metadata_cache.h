@@ -0,0 +1,86 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef METADATA_CACHE_H
+#define METADATA_CACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/crail_constants.h"
+#include "metadata/block_info.h"
+#include "metadata/file_info.h"
+
+using namespace std;
+using namespace crail;
+
+// Client side cache of lookup results. An entry is trusted for ttl
+// milliseconds after the namenode returned it, names the namenode did not
+// find are remembered for negative_ttl milliseconds. A ttl of 0 disables
+// the respective kind of entry.
+class MetadataCache {
+public:
+  MetadataCache();
+  virtual ~MetadataCache();
+
+  // 1 if name is cached as a file, 0 if it is cached as missing, -1 if the
+  // namenode has to be asked
+  int Get(const string &name, shared_ptr<FileInfo> &file_info,
+          shared_ptr<BlockInfo> &block_info);
+  void Put(const string &name, shared_ptr<FileInfo> file_info,
+           shared_ptr<BlockInfo> block_info);
+  void PutMissing(const string &name);
+  void Invalidate(const string &name, bool recursive);
+
+  void set_ttl(int ttl) { this->ttl_ = ttl; }
+  int ttl() const { return ttl_; }
+  void set_negative_ttl(int negative_ttl) {
+    this->negative_ttl_ = negative_ttl;
+  }
+  int negative_ttl() const { return negative_ttl_; }
+
+private:
+  struct Entry {
+    shared_ptr<FileInfo> file_info;
+    shared_ptr<BlockInfo> block_info;
+    chrono::steady_clock::time_point expiry;
+  };
+  struct Shard {
+    mutex lock;
+    unordered_map<string, Entry> entries;
+  };
+
+  void Insert(const string &name, shared_ptr<FileInfo> file_info,
+              shared_ptr<BlockInfo> block_info, int ttl);
+  Shard &GetShard(const string &name);
+
+  Shard shards_[kCacheShards];
+  atomic<int> ttl_;
+  atomic<int> negative_ttl_;
+};
+
+#endif /* METADATA_CACHE_H */
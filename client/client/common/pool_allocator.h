@@ -0,0 +1,120 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <memory>
+#include <new>
+#include <utility>
+
+using namespace std;
+
+namespace crail {
+
+// number of freed objects each thread keeps around per type
+const int kPoolDepth = 64;
+
+// Allocator that recycles single-object allocations through a per-thread,
+// per-type free list. Used with allocate_shared so that the object and its
+// control block come out of the list instead of the heap.
+template <class T> class PoolAllocator {
+public:
+  typedef T value_type;
+
+  PoolAllocator() noexcept {}
+  template <class U> PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+  T *allocate(size_t n) {
+    static_assert(sizeof(T) >= sizeof(Node), "type too small to pool");
+    if (n == 1 && !destroyed_) {
+      FreeList &list = free_list();
+      if (list.head) {
+        Node *node = list.head;
+        list.head = node->next;
+        list.count--;
+        return reinterpret_cast<T *>(node);
+      }
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T *ptr, size_t n) {
+    if (n == 1 && !destroyed_) {
+      FreeList &list = free_list();
+      if (list.count < kPoolDepth) {
+        Node *node = reinterpret_cast<Node *>(ptr);
+        node->next = list.head;
+        list.head = node;
+        list.count++;
+        return;
+      }
+    }
+    ::operator delete(ptr);
+  }
+
+private:
+  struct Node {
+    Node *next;
+  };
+
+  struct FreeList {
+    Node *head = nullptr;
+    int count = 0;
+    ~FreeList() {
+      destroyed_ = true;
+      while (head) {
+        Node *node = head;
+        head = node->next;
+        ::operator delete(node);
+      }
+    }
+  };
+
+  static FreeList &free_list() {
+    static thread_local FreeList list;
+    return list;
+  }
+
+  // trivially destructible, still valid while thread locals are torn down
+  static thread_local bool destroyed_;
+};
+
+template <class T> thread_local bool PoolAllocator<T>::destroyed_ = false;
+
+template <class T, class U>
+bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &) {
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &) {
+  return false;
+}
+
+template <class T, class... Args> shared_ptr<T> MakePooled(Args &&... args) {
+  return allocate_shared<T>(PoolAllocator<T>(), forward<Args>(args)...);
+}
+} // namespace crail
+
+#endif /* POOL_ALLOCATOR_H */
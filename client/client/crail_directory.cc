@@ -26,8 +26,8 @@
 #include <iostream>
 #include <memory>
 
+#include "common/buffer_pool.h"
 #include "crail_inputstream.h"
-#include "directory_record.h"
 
 CrailDirectory::CrailDirectory(shared_ptr<FileInfo> file_info,
                                shared_ptr<NamenodeClient> namenode_client,
@@ -42,18 +42,51 @@ CrailDirectory::CrailDirectory(shared_ptr<FileInfo> file_info,
 CrailDirectory::~CrailDirectory() {}
 
 int CrailDirectory::Enumerate() {
-  int records = file_info_->capacity() / 512;
+  vector<string> names;
+  if (List(names) < 0) {
+    return -1;
+  }
+  for (string &name : names) {
+    cout << name.c_str() << endl;
+  }
+
+  return 0;
+}
+
+int CrailDirectory::List(vector<string> &names) {
+  unsigned long long capacity = file_info_->capacity();
   unique_ptr<CrailInputstream> input_stream = make_unique<CrailInputstream>(
       namenode_client_, storage_cache_, block_cache_, file_info_, 0);
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(512);
-  DirectoryRecord record;
-  for (int i = 0; i < records; i++) {
-    buf->Clear();
-    input_stream->Read(buf);
-    buf->Flip();
-    record.Update(*buf);
-    if (record.valid()) {
-      cout << record.name().c_str() << endl;
+  shared_ptr<ByteBuffer> chunk = BufferPool::Instance().Get(kBufferSize);
+  if (!chunk) {
+    return -1;
+  }
+  names.reserve(names.size() + capacity / kDirectoryRecord);
+
+  // the directory is fetched a chunk of records at a time, all blocks of a
+  // chunk in parallel, and the records are parsed where they landed
+  int slots = kBufferSize / kDirectoryRecord;
+  for (unsigned long long offset = 0; offset < capacity;
+       offset += slots * kDirectoryRecord) {
+    chunk->Clear();
+    if (capacity - offset < (unsigned long long)kBufferSize) {
+      chunk->set_limit(capacity - offset);
+    }
+    shared_ptr<Future> read = input_stream->ReadAsync(chunk);
+    if (!read || read->Get() < 0) {
+      return -1;
+    }
+    chunk->Flip();
+
+    for (int slot = 0; slot + kDirectoryRecord <= chunk->limit();
+         slot += kDirectoryRecord) {
+      chunk->set_position(slot);
+      int valid = chunk->GetInt();
+      int length = chunk->GetInt();
+      if (valid && length > 0 &&
+          length <= kDirectoryRecord - (int)sizeof(int) * 2) {
+        names.emplace_back((const char *)chunk->get_bytes(), length);
+      }
     }
   }
 
@@ -24,6 +24,9 @@
 #ifndef CRAIL_DIRECTORY_H
 #define CRAIL_DIRECTORY_H
 
+#include <string>
+#include <vector>
+
 #include "crail_node.h"
 #include "metadata/file_info.h"
 #include "namenode/namenode_client.h"
@@ -38,6 +41,8 @@ public:
   virtual ~CrailDirectory();
 
   int Enumerate();
+  // appends the names of all valid records
+  int List(vector<string> &names);
 
 private:
   shared_ptr<NamenodeClient> namenode_client_;
@@ -26,6 +26,10 @@
 #include <iostream>
 #include <memory>
 
+#include "common/buffer_pool.h"
+#include "common/client_stats.h"
+#include "common/future_group.h"
+#include "namenode/getblock_range_response.h"
 #include "namenode/getblock_response.h"
 #include "storage/narpc/narpc_storage_client.h"
 #include "storage/storage_client.h"
@@ -41,15 +45,37 @@ CrailInputstream::CrailInputstream(shared_ptr<NamenodeClient> namenode_client,
   this->storage_cache_ = storage_cache;
   this->block_cache_ = block_cache;
   this->position_ = position;
+  this->read_ahead_ = kReadAhead;
+  this->fetch_position_ = position;
 }
 
-CrailInputstream::~CrailInputstream() {}
+CrailInputstream::~CrailInputstream() { Drain(); }
 
 int CrailInputstream::Read(shared_ptr<ByteBuffer> buf) {
   if (position_ >= file_info_->capacity()) {
     return -1;
   }
 
+  // read-ahead only pays off if the stream spans more than the current
+  // block, small objects are read straight into the caller's buffer
+  StatTimer timer(Stat::StreamRead);
+  unsigned long long block_remaining = kBlockSize - position_ % kBlockSize;
+  unsigned long long file_remaining = file_info_->capacity() - position_;
+  int len;
+  if (!slots_.empty() || (read_ahead_ > 0 && file_remaining > block_remaining)) {
+    len = ReadAhead(buf);
+  } else {
+    len = ReadDirect(buf);
+  }
+  if (len > 0) {
+    timer.set_bytes(len);
+  }
+  return len;
+}
+
+int CrailInputstream::Close() { return Drain(); }
+
+int CrailInputstream::ReadDirect(shared_ptr<ByteBuffer> buf) {
   int buf_original_limit = buf->limit();
   int block_offset = position_ % kBlockSize;
   int block_remaining = kBlockSize - block_offset;
@@ -58,48 +84,16 @@ int CrailInputstream::Read(shared_ptr<ByteBuffer> buf) {
   if (block_remaining < buf->remaining()) {
     buf->set_limit(buf->position() + block_remaining);
   }
-  if (file_remaining < buf->remaining()) {
+  if (file_remaining < (unsigned long long)buf->remaining()) {
     buf->set_limit(buf->position() + file_remaining);
   }
 
-  shared_ptr<BlockInfo> block_info = block_cache_->GetBlock(position_);
+  shared_ptr<BlockInfo> block_info = GetBlock(position_);
   if (!block_info) {
-    shared_ptr<GetblockResponse> get_block_res = namenode_client_->GetBlock(
-        file_info_->fd(), file_info_->token(), position_, 0);
-
-    if (!get_block_res) {
-      return -1;
-    }
-
-    if (get_block_res->Get() < 0) {
-      return -1;
-    }
-
-    block_info = get_block_res->block_info();
-    block_cache_->PutBlock(position_, block_info);
-    /*
-        cout << "got new block info, address "
-             << GetAddress(block_info->datanode()->addr(),
-                           block_info->datanode()->port())
-             << ", position " << position_ << ", addr " << block_info->addr()
-             << ", lba " << block_info->lba() << ", length " <<
-       block_info->length()
-             << endl;
-    */
-  }
-
-  int address = block_info->datanode()->addr();
-  int port = block_info->datanode()->port();
-
-  shared_ptr<StorageClient> storage_client = storage_cache_->Get(
-      block_info->datanode()->Key(), block_info->datanode()->storage_class());
-  if (storage_client->Connect(address, port) < 0) {
     return -1;
   }
 
-  long long block_addr = block_info->addr() + block_offset;
-  shared_ptr<Future> storage_response =
-      storage_client->ReadData(block_info->lkey(), block_addr, buf);
+  shared_ptr<Future> storage_response = IssueRead(block_info, position_, buf);
   if (!storage_response) {
     return -1;
   }
@@ -116,4 +110,237 @@ int CrailInputstream::Read(shared_ptr<ByteBuffer> buf) {
   return len;
 }
 
-int CrailInputstream::Close() {}
+int CrailInputstream::ReadAhead(shared_ptr<ByteBuffer> buf) {
+  if (Fill() < 0) {
+    return -1;
+  }
+  if (slots_.empty()) {
+    return -1;
+  }
+
+  ReadSlot &slot = slots_.front();
+  if (slot.future) {
+    if (slot.future->Get() < 0) {
+      return -1;
+    }
+    slot.future = nullptr;
+  }
+
+  int offset = position_ - slot.position;
+  int len = slot.length - offset;
+  if (len > buf->remaining()) {
+    len = buf->remaining();
+  }
+  buf->PutBytes((char *)slot.buffer->get_bytes() + offset, len);
+  this->position_ += len;
+
+  if (position_ == slot.position + slot.length) {
+    free_buffers_.push_back(slot.buffer);
+    slots_.pop_front();
+    if (Fill() < 0) {
+      return -1;
+    }
+  }
+
+  return len;
+}
+
+int CrailInputstream::Fill() {
+  unsigned long long capacity = file_info_->capacity();
+  int count = read_ahead_ - slots_.size();
+  if (count <= 0 || fetch_position_ >= capacity) {
+    return 0;
+  }
+
+  vector<unsigned long long> positions;
+  unsigned long long position = fetch_position_;
+  for (int i = 0; i < count && position < capacity; i++) {
+    positions.push_back(position);
+    position += kBlockSize - position % kBlockSize;
+  }
+  if (ResolveBlocks(positions) < 0) {
+    return -1;
+  }
+
+  for (unsigned long long position : positions) {
+    unsigned long long block_remaining = kBlockSize - position % kBlockSize;
+    unsigned long long file_remaining = capacity - position;
+    unsigned long long length = block_remaining;
+    if (file_remaining < length) {
+      length = file_remaining;
+    }
+
+    shared_ptr<ByteBuffer> buffer = nullptr;
+    if (!free_buffers_.empty()) {
+      buffer = free_buffers_.back();
+      free_buffers_.pop_back();
+    } else {
+      buffer = BufferPool::Instance().Get(kBlockSize);
+      if (!buffer) {
+        return -1;
+      }
+    }
+    buffer->Clear();
+    buffer->set_limit(length);
+
+    shared_ptr<BlockInfo> block_info = GetBlock(position);
+    if (!block_info) {
+      return -1;
+    }
+    shared_ptr<Future> future = IssueRead(block_info, position, buffer);
+    if (!future) {
+      return -1;
+    }
+
+    ReadSlot slot;
+    slot.position = position;
+    slot.length = length;
+    slot.buffer = buffer;
+    slot.future = future;
+    slots_.push_back(slot);
+    fetch_position_ = position + length;
+  }
+
+  return 0;
+}
+
+int CrailInputstream::ResolveBlocks(vector<unsigned long long> &positions) {
+  // resolve all missing block locations with one namenode round-trip
+  int missing = -1;
+  for (int i = 0; i < (int)positions.size() && missing < 0; i++) {
+    if (!block_cache_->GetBlock(positions[i])) {
+      missing = i;
+    }
+  }
+  if (missing < 0) {
+    return 0;
+  }
+
+  unsigned long long start = positions[missing];
+  start -= start % kBlockSize;
+  unsigned long long end = positions.back() + kBlockSize;
+  end -= end % kBlockSize;
+  shared_ptr<GetblockRangeResponse> lookup = namenode_client_->GetBlockRange(
+      file_info_->fd(), file_info_->token(), start, end - start);
+  if (!lookup || lookup->Get() < 0 || lookup->error() != 0) {
+    // namenodes without range lookups are asked block by block
+    for (int i = missing; i < (int)positions.size(); i++) {
+      if (!GetBlock(positions[i])) {
+        return -1;
+      }
+    }
+    return 0;
+  }
+  for (int i = 0; i < lookup->count() && missing + i < (int)positions.size();
+       i++) {
+    block_cache_->PutBlock(positions[missing + i], lookup->block_info(i));
+  }
+  return 0;
+}
+
+shared_ptr<Future> CrailInputstream::ReadAsync(shared_ptr<ByteBuffer> buf) {
+  if (Drain() < 0) {
+    return nullptr;
+  }
+
+  unsigned long long capacity = file_info_->capacity();
+  unsigned long long length = buf->remaining();
+  if (position_ >= capacity) {
+    length = 0;
+  } else if (capacity - position_ < length) {
+    length = capacity - position_;
+  }
+
+  vector<unsigned long long> positions;
+  unsigned long long end = position_ + length;
+  for (unsigned long long position = position_; position < end;
+       position += kBlockSize - position % kBlockSize) {
+    positions.push_back(position);
+  }
+  if (ResolveBlocks(positions) < 0) {
+    return nullptr;
+  }
+
+  // every block is read straight into its part of the caller's buffer
+  shared_ptr<FutureGroup> group = make_shared<FutureGroup>();
+  unsigned char *data = buf->get_bytes();
+  for (unsigned long long position : positions) {
+    unsigned long long chunk = kBlockSize - position % kBlockSize;
+    if (end - position < chunk) {
+      chunk = end - position;
+    }
+    shared_ptr<BlockInfo> block_info = GetBlock(position);
+    if (!block_info) {
+      group->Get();
+      return nullptr;
+    }
+    shared_ptr<ByteBuffer> view =
+        make_shared<ByteBuffer>(data + (position - position_), chunk);
+    shared_ptr<Future> future = IssueRead(block_info, position, view);
+    if (!future) {
+      group->Get();
+      return nullptr;
+    }
+    group->Add(future, view);
+  }
+
+  buf->set_position(buf->position() + length);
+  position_ = end;
+  fetch_position_ = end;
+  return group;
+}
+
+int CrailInputstream::Drain() {
+  int res = 0;
+  while (!slots_.empty()) {
+    ReadSlot &slot = slots_.front();
+    if (slot.future && slot.future->Get() < 0) {
+      res = -1;
+    }
+    slots_.pop_front();
+  }
+  fetch_position_ = position_;
+  return res;
+}
+
+shared_ptr<BlockInfo> CrailInputstream::GetBlock(unsigned long long position) {
+  shared_ptr<BlockInfo> block_info = block_cache_->GetBlock(position);
+  if (block_info) {
+    return block_info;
+  }
+
+  shared_ptr<GetblockResponse> get_block_res = namenode_client_->GetBlock(
+      file_info_->fd(), file_info_->token(), position, 0);
+
+  if (!get_block_res) {
+    return nullptr;
+  }
+
+  if (get_block_res->Get() < 0) {
+    return nullptr;
+  }
+
+  if (get_block_res->error() != 0) {
+    return nullptr;
+  }
+
+  block_info = get_block_res->block_info();
+  block_cache_->PutBlock(position, block_info);
+  return block_info;
+}
+
+shared_ptr<Future> CrailInputstream::IssueRead(shared_ptr<BlockInfo> block_info,
+                                               unsigned long long position,
+                                               shared_ptr<ByteBuffer> buf) {
+  int address = block_info->datanode()->addr();
+  int port = block_info->datanode()->port();
+
+  shared_ptr<StorageClient> storage_client = storage_cache_->Get(
+      block_info->datanode()->Key(), block_info->datanode()->storage_class());
+  if (storage_client->Connect(address, port) < 0) {
+    return nullptr;
+  }
+
+  long long block_addr = block_info->addr() + position % kBlockSize;
+  return storage_client->ReadData(block_info->lkey(), block_addr, buf);
+}
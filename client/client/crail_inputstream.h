@@ -24,10 +24,13 @@
 #ifndef CRAIL_INPUTSTREAM_H
 #define CRAIL_INPUTSTREAM_H
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "common/block_cache.h"
 #include "common/byte_buffer.h"
+#include "common/future.h"
 #include "namenode/namenode_client.h"
 #include "storage/storage_cache.h"
 
@@ -40,17 +43,45 @@ public:
   virtual ~CrailInputstream();
 
   int Read(shared_ptr<ByteBuffer> buf);
+  // issues the reads for all of buf's remaining bytes (bounded by the end
+  // of the file) at once, buf is filled when the returned future completes
+  shared_ptr<Future> ReadAsync(shared_ptr<ByteBuffer> buf);
   int Close();
 
   int position() const { return position_; }
   int capacity() const { return file_info_->capacity(); }
+  int read_ahead() const { return read_ahead_; }
+  void set_read_ahead(int read_ahead) {
+    this->read_ahead_ = read_ahead > 0 ? read_ahead : 0;
+  }
 
 private:
+  struct ReadSlot {
+    unsigned long long position;
+    int length;
+    shared_ptr<ByteBuffer> buffer;
+    shared_ptr<Future> future;
+  };
+
+  int ReadDirect(shared_ptr<ByteBuffer> buf);
+  int ReadAhead(shared_ptr<ByteBuffer> buf);
+  int Fill();
+  int Drain();
+  int ResolveBlocks(vector<unsigned long long> &positions);
+  shared_ptr<BlockInfo> GetBlock(unsigned long long position);
+  shared_ptr<Future> IssueRead(shared_ptr<BlockInfo> block_info,
+                               unsigned long long position,
+                               shared_ptr<ByteBuffer> buf);
+
   shared_ptr<FileInfo> file_info_;
   shared_ptr<NamenodeClient> namenode_client_;
   shared_ptr<StorageCache> storage_cache_;
   shared_ptr<BlockCache> block_cache_;
   unsigned long long position_;
+  int read_ahead_;
+  unsigned long long fetch_position_;
+  deque<ReadSlot> slots_;
+  vector<shared_ptr<ByteBuffer>> free_buffers_;
 };
 
 #endif /* CRAIL_INPUTSTREAM_H */
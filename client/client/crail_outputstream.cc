@@ -26,6 +26,7 @@
 #include <iostream>
 #include <memory>
 
+#include "common/client_stats.h"
 #include "namenode/getblock_response.h"
 #include "storage/narpc/narpc_storage_client.h"
 #include "storage/storage_client.h"
@@ -43,9 +44,12 @@ CrailOutputstream::CrailOutputstream(shared_ptr<NamenodeClient> namenode_client,
   this->storage_cache_ = storage_cache;
   this->block_cache_ = block_cache;
   this->position_ = position;
+  this->window_ = kWriteWindow;
+  this->next_block_ = nullptr;
+  this->next_position_ = 0;
 }
 
-CrailOutputstream::~CrailOutputstream() {}
+CrailOutputstream::~CrailOutputstream() { Sync(); }
 
 int CrailOutputstream::Write(shared_ptr<ByteBuffer> buf) {
   if (buf->remaining() < 0) {
@@ -55,6 +59,7 @@ int CrailOutputstream::Write(shared_ptr<ByteBuffer> buf) {
     return 0;
   }
 
+  StatTimer timer(Stat::StreamWrite);
   int buf_original_limit = buf->limit();
   int block_offset = position_ % kBlockSize;
   int block_remaining = kBlockSize - block_offset;
@@ -63,21 +68,9 @@ int CrailOutputstream::Write(shared_ptr<ByteBuffer> buf) {
     buf->set_limit(buf->position() + block_remaining);
   }
 
-  shared_ptr<BlockInfo> block_info = block_cache_->GetBlock(position_);
+  shared_ptr<BlockInfo> block_info = GetBlock(position_);
   if (!block_info) {
-    shared_ptr<GetblockResponse> get_block_res = namenode_client_->GetBlock(
-        file_info_->fd(), file_info_->token(), position_, position_);
-
-    if (!get_block_res) {
-      return -1;
-    }
-
-    if (get_block_res->Get() < 0) {
-      return -1;
-    }
-
-    block_info = get_block_res->block_info();
-    block_cache_->PutBlock(position_, block_info);
+    return -1;
   }
 
   int address = block_info->datanode()->addr();
@@ -89,30 +82,56 @@ int CrailOutputstream::Write(shared_ptr<ByteBuffer> buf) {
     return -1;
   }
 
+  // the payload is on the wire once WriteData returns, only the
+  // acknowledgements are outstanding
+  while ((int)pending_.size() >= window_) {
+    shared_ptr<Future> oldest = pending_.front();
+    pending_.pop_front();
+    if (oldest->Get() < 0) {
+      return -1;
+    }
+  }
+
   long long block_addr = block_info->addr() + block_offset;
   shared_ptr<Future> storage_response =
       storage_client->WriteData(block_info->lkey(), block_addr, buf);
   if (!storage_response) {
     return -1;
   }
-
-  if (storage_response->Get() < 0) {
-    return -1;
-  }
+  pending_.push_back(storage_response);
 
   int len = buf->remaining();
+  timer.set_bytes(len);
   this->position_ += buf->remaining();
   buf->set_position(buf->position() + buf->remaining());
   buf->set_limit(buf_original_limit);
 
+  if (buf->remaining() > 0 && PrefetchBlock(position_) < 0) {
+    return -1;
+  }
+
   return len;
 }
 
-int CrailOutputstream::Close() {
-  file_info_->set_capacity(position_);
-  shared_ptr<VoidResponse> set_file_res =
-      namenode_client_->SetFile(file_info_, true);
+int CrailOutputstream::Sync() {
+  int res = 0;
+  while (!pending_.empty()) {
+    shared_ptr<Future> oldest = pending_.front();
+    pending_.pop_front();
+    if (oldest->Get() < 0) {
+      res = -1;
+    }
+  }
+  if (next_block_) {
+    next_block_->Get();
+    next_block_ = nullptr;
+  }
+  return res;
+}
 
+int CrailOutputstream::Close() {
+  StatTimer timer(Stat::StreamClose);
+  shared_ptr<Future> set_file_res = CloseAsync();
   if (!set_file_res) {
     return -1;
   }
@@ -123,3 +142,75 @@ int CrailOutputstream::Close() {
 
   return 0;
 }
+
+shared_ptr<Future> CrailOutputstream::CloseAsync() {
+  // the capacity is committed only once every data write is acknowledged,
+  // readers never see an object before its bytes have landed
+  if (Sync() < 0) {
+    return nullptr;
+  }
+
+  file_info_->set_capacity(position_);
+  return namenode_client_->SetFile(file_info_, true);
+}
+
+shared_ptr<FileInfo> CrailOutputstream::CloseDeferred() {
+  if (Sync() < 0) {
+    return nullptr;
+  }
+
+  file_info_->set_capacity(position_);
+  return file_info_;
+}
+
+shared_ptr<BlockInfo>
+CrailOutputstream::GetBlock(unsigned long long position) {
+  shared_ptr<BlockInfo> block_info = block_cache_->GetBlock(position);
+  if (block_info) {
+    return block_info;
+  }
+
+  shared_ptr<GetblockResponse> get_block_res = nullptr;
+  if (next_block_ && next_position_ == position) {
+    get_block_res = next_block_;
+    next_block_ = nullptr;
+  } else {
+    get_block_res = namenode_client_->GetBlock(
+        file_info_->fd(), file_info_->token(), position, position);
+  }
+
+  if (!get_block_res) {
+    return nullptr;
+  }
+
+  if (get_block_res->Get() < 0) {
+    return nullptr;
+  }
+
+  if (get_block_res->error() != 0) {
+    cout << "getblock failed, position " << position << ", error "
+         << get_block_res->error() << endl;
+    return nullptr;
+  }
+
+  block_info = get_block_res->block_info();
+  block_cache_->PutBlock(position, block_info);
+  return block_info;
+}
+
+int CrailOutputstream::PrefetchBlock(unsigned long long position) {
+  if (next_block_ || position % kBlockSize != 0) {
+    return 0;
+  }
+  if (block_cache_->GetBlock(position)) {
+    return 0;
+  }
+
+  next_block_ = namenode_client_->GetBlock(
+      file_info_->fd(), file_info_->token(), position, position);
+  if (!next_block_) {
+    return -1;
+  }
+  next_position_ = position;
+  return 0;
+}
@@ -24,10 +24,12 @@
 #ifndef CRAIL_OUTPUTSTREAM_H
 #define CRAIL_OUTPUTSTREAM_H
 
+#include <deque>
 #include <memory>
 
 #include "common/block_cache.h"
 #include "common/byte_buffer.h"
+#include "common/future.h"
 #include "namenode/namenode_client.h"
 #include "storage/storage_cache.h"
 
@@ -44,17 +46,32 @@ public:
   virtual ~CrailOutputstream();
 
   int Write(shared_ptr<ByteBuffer> buf);
+  int Sync();
   int Close();
+  // flushes the data but leaves the final SetFile in flight
+  shared_ptr<Future> CloseAsync();
+  // flushes the data and leaves the SetFile of the returned file to the
+  // caller
+  shared_ptr<FileInfo> CloseDeferred();
 
   unsigned long long position() const { return position_; }
   int capacity() const { return file_info_->capacity(); }
+  int window() const { return window_; }
+  void set_window(int window) { this->window_ = window > 0 ? window : 1; }
 
 private:
+  shared_ptr<BlockInfo> GetBlock(unsigned long long position);
+  int PrefetchBlock(unsigned long long position);
+
   shared_ptr<FileInfo> file_info_;
   shared_ptr<NamenodeClient> namenode_client_;
   shared_ptr<StorageCache> storage_cache_;
   shared_ptr<BlockCache> block_cache_;
   unsigned long long position_;
+  int window_;
+  deque<shared_ptr<Future>> pending_;
+  shared_ptr<GetblockResponse> next_block_;
+  unsigned long long next_position_;
 };
 
 #endif /* CRAIL_OUTPUTSTREAM_H */
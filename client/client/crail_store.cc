@@ -30,6 +30,7 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include "common/client_stats.h"
 #include "common/crail_constants.h"
 #include "crail_directory.h"
 #include "crail_file.h"
@@ -40,10 +41,13 @@
 using namespace crail;
 
 CrailStore::CrailStore()
-    : namenode_client_(new NamenodeClient()),
-      storage_cache_(new StorageCache()) {}
+    : event_loop_(new EventLoop()),
+      namenode_client_(new NamenodeClient(event_loop_)),
+      storage_cache_(new StorageCache(event_loop_)), block_prefetch_(0),
+      deferred_count_(0), deferred_error_(0) {}
 
 CrailStore::~CrailStore() {
+  Flush();
   this->namenode_client_->Close();
   storage_cache_->Close();
 }
@@ -52,15 +56,46 @@ int CrailStore::Initialize(string address, int port) {
   return this->namenode_client_->Connect((int)inet_addr(address.c_str()), port);
 }
 
-unique_ptr<CrailNode> CrailStore::Create(string &name, FileType type,
+unique_ptr<CrailNode> CrailStore::Create(const string &name, FileType type,
                                          int storage_class, int location_class,
                                          bool enumerable) {
+  StatTimer timer(Stat::StoreCreate);
+  metadata_cache_.Invalidate(name, false);
   Filename filename(name);
   int _enumerable = enumerable ? 1 : 0;
   auto create_res =
       namenode_client_->Create(filename, static_cast<int>(type), storage_class,
                                location_class, _enumerable);
+  return CompleteCreate(create_res, filename);
+}
+
+vector<unique_ptr<CrailNode>>
+CrailStore::Create(const vector<string> &names, FileType type,
+                   int storage_class, int location_class, bool enumerable) {
+  // all creates go out before the first reply is awaited
+  int _enumerable = enumerable ? 1 : 0;
+  vector<Filename> filenames;
+  vector<shared_ptr<CreateResponse>> responses;
+  filenames.reserve(names.size());
+  responses.reserve(names.size());
+  for (const string &name : names) {
+    metadata_cache_.Invalidate(name, false);
+    filenames.emplace_back(name);
+    responses.push_back(namenode_client_->Create(
+        filenames.back(), static_cast<int>(type), storage_class,
+        location_class, _enumerable));
+  }
+
+  vector<unique_ptr<CrailNode>> nodes;
+  for (unsigned i = 0; i < responses.size(); i++) {
+    nodes.push_back(CompleteCreate(responses[i], filenames[i]));
+  }
+  return nodes;
+}
 
+unique_ptr<CrailNode>
+CrailStore::CompleteCreate(shared_ptr<CreateResponse> create_res,
+                           const Filename &filename) {
   if (!create_res) {
     return nullptr;
   }
@@ -80,17 +115,73 @@ unique_ptr<CrailNode> CrailStore::Create(string &name, FileType type,
   if (dir_offset >= 0) {
     auto parent_info = create_res->parent();
     AddBlock(parent_info->fd(), dir_offset, create_res->parent_block());
-    string _name = filename.name();
-    WriteDirectoryRecord(parent_info, _name, dir_offset, 1);
+    WriteDirectoryRecord(parent_info, filename.name(), dir_offset, 1);
   }
 
   return DispatchType(file_info);
 }
 
-unique_ptr<CrailNode> CrailStore::Lookup(string &name) {
+unique_ptr<CrailNode> CrailStore::Lookup(const string &name) {
+  StatTimer timer(Stat::StoreLookup);
+  if (deferred_count_ > 0) {
+    DrainDeferred();
+  }
+
+  unique_ptr<CrailNode> node = nullptr;
+  if (LookupCached(name, node)) {
+    return node;
+  }
+
   Filename filename(name);
   auto lookup_res = namenode_client_->Lookup(filename);
+  return CompleteLookup(lookup_res, name);
+}
+
+vector<unique_ptr<CrailNode>>
+CrailStore::Lookup(const vector<string> &names) {
+  if (deferred_count_ > 0) {
+    DrainDeferred();
+  }
+
+  vector<unique_ptr<CrailNode>> nodes(names.size());
+  vector<shared_ptr<LookupResponse>> responses(names.size());
+  vector<bool> cached(names.size());
+  for (unsigned i = 0; i < names.size(); i++) {
+    cached[i] = LookupCached(names[i], nodes[i]);
+    if (!cached[i]) {
+      Filename filename(names[i]);
+      responses[i] = namenode_client_->Lookup(filename);
+    }
+  }
+
+  for (unsigned i = 0; i < names.size(); i++) {
+    if (!cached[i]) {
+      nodes[i] = CompleteLookup(responses[i], names[i]);
+    }
+  }
+  return nodes;
+}
+
+bool CrailStore::LookupCached(const string &name,
+                              unique_ptr<CrailNode> &node) {
+  shared_ptr<FileInfo> file_info = nullptr;
+  shared_ptr<BlockInfo> block_info = nullptr;
+  int res = metadata_cache_.Get(name, file_info, block_info);
+  if (res < 0) {
+    return false;
+  }
+
+  node = nullptr;
+  if (res > 0) {
+    AddBlock(file_info->fd(), 0, block_info);
+    node = DispatchType(file_info);
+  }
+  return true;
+}
 
+unique_ptr<CrailNode>
+CrailStore::CompleteLookup(shared_ptr<LookupResponse> lookup_res,
+                           const string &name) {
   if (!lookup_res) {
     return nullptr;
   }
@@ -99,16 +190,29 @@ unique_ptr<CrailNode> CrailStore::Lookup(string &name) {
     return nullptr;
   }
 
+  if (lookup_res->error() == kErrGetFileFailed) {
+    metadata_cache_.PutMissing(name);
+  }
   if (lookup_res->error() != 0) {
     return nullptr;
   }
 
   auto file_info = lookup_res->file();
+  metadata_cache_.Put(name, file_info, lookup_res->file_block());
   AddBlock(file_info->fd(), 0, lookup_res->file_block());
+  if (file_info->capacity() <= block_prefetch_) {
+    PrefetchBlocks(file_info);
+  }
   return DispatchType(file_info);
 }
 
-int CrailStore::Remove(string &name, bool recursive) {
+int CrailStore::Remove(const string &name, bool recursive) {
+  StatTimer timer(Stat::StoreRemove);
+  if (deferred_count_ > 0) {
+    DrainDeferred();
+  }
+
+  metadata_cache_.Invalidate(name, recursive);
   Filename filename(name);
   auto remove_res = namenode_client_->Remove(filename, recursive);
 
@@ -124,15 +228,91 @@ int CrailStore::Remove(string &name, bool recursive) {
     return -1;
   }
 
+  DropBlockCache(remove_res->file()->fd());
   auto parent_info = remove_res->parent();
   long long dir_offset = remove_res->file()->dir_offset();
-  string _name = filename.name();
-  WriteDirectoryRecord(parent_info, _name, dir_offset, 0);
+  WriteDirectoryRecord(parent_info, filename.name(), dir_offset, 0);
 
   return 0;
 }
 
-int CrailStore::Ioctl(unsigned char op, string &name) {
+int CrailStore::Remove(const vector<string> &names, bool recursive) {
+  StatTimer timer(Stat::StoreRemove);
+  if (deferred_count_ > 0) {
+    DrainDeferred();
+  }
+
+  vector<Filename> filenames;
+  filenames.reserve(names.size());
+  for (const string &name : names) {
+    metadata_cache_.Invalidate(name, recursive);
+    filenames.emplace_back(name);
+  }
+  vector<shared_ptr<RemoveResponse>> responses;
+  if (namenode_client_->Remove(filenames, recursive, responses) < 0) {
+    return -1;
+  }
+
+  vector<bool> removed(names.size());
+  unordered_set<string> removed_dirs;
+  for (unsigned i = 0; i < responses.size(); i++) {
+    shared_ptr<RemoveResponse> &remove_res = responses[i];
+    removed[i] = remove_res->Get() == 0 && remove_res->error() == 0;
+    if (removed[i] && recursive) {
+      removed_dirs.insert(names[i]);
+    }
+  }
+
+  // tombstones are written all at once, and not at all into a directory
+  // that went away with the same batch
+  int res = 0;
+  vector<unique_ptr<CrailOutputstream>> streams;
+  for (unsigned i = 0; i < responses.size(); i++) {
+    bool orphan =
+        !removed_dirs.empty() && HasRemovedParent(names[i], removed_dirs);
+    if (!removed[i]) {
+      // names below a removed directory are gone either way
+      if (!orphan) {
+        res = -1;
+      }
+      continue;
+    }
+    shared_ptr<RemoveResponse> &remove_res = responses[i];
+    DropBlockCache(remove_res->file()->fd());
+    if (orphan) {
+      continue;
+    }
+    if (IssueDirectoryRecord(remove_res->parent(), filenames[i].name(),
+                             remove_res->file()->dir_offset(), 0,
+                             streams) < 0) {
+      res = -1;
+    }
+  }
+  for (unique_ptr<CrailOutputstream> &stream : streams) {
+    if (stream->Sync() < 0) {
+      res = -1;
+    }
+  }
+
+  return res;
+}
+
+bool CrailStore::HasRemovedParent(const string &name,
+                                  unordered_set<string> &removed_dirs) {
+  for (size_t slash = name.rfind('/'); slash != string::npos && slash > 0;
+       slash = name.rfind('/', slash - 1)) {
+    if (removed_dirs.count(name.substr(0, slash)) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int CrailStore::Ioctl(unsigned char op, const string &name) {
+  if (deferred_count_ > 0) {
+    DrainDeferred();
+  }
+
   Filename filename(name);
   shared_ptr<IoctlResponse> ioctl_res = namenode_client_->Ioctl(op, filename);
 
@@ -150,6 +330,77 @@ int CrailStore::Ioctl(unsigned char op, string &name) {
   return ioctl_res->count();
 }
 
+int CrailStore::CloseDeferred(unique_ptr<CrailOutputstream> outputstream) {
+  shared_ptr<FileInfo> file_info = outputstream->CloseDeferred();
+  if (!file_info) {
+    return -1;
+  }
+
+  lock_guard<mutex> guard(deferred_lock_);
+  deferred_files_.push_back(file_info);
+  deferred_count_++;
+  if ((int)deferred_files_.size() < kCloseBatch) {
+    return 0;
+  }
+
+  // the previous batch had a whole batch worth of time to complete
+  vector<shared_ptr<VoidResponse>> previous;
+  previous.swap(deferred_responses_);
+  if (SendDeferred() < 0) {
+    deferred_error_ = -1;
+  }
+  if (WaitDeferred(previous) < 0) {
+    deferred_error_ = -1;
+  }
+  return 0;
+}
+
+int CrailStore::Flush() {
+  DrainDeferred();
+
+  lock_guard<mutex> guard(deferred_lock_);
+  int res = deferred_error_;
+  deferred_error_ = 0;
+  return res;
+}
+
+void CrailStore::DrainDeferred() {
+  lock_guard<mutex> guard(deferred_lock_);
+  if (SendDeferred() < 0) {
+    deferred_error_ = -1;
+  }
+  vector<shared_ptr<VoidResponse>> responses;
+  responses.swap(deferred_responses_);
+  if (WaitDeferred(responses) < 0) {
+    deferred_error_ = -1;
+  }
+}
+
+int CrailStore::SendDeferred() {
+  if (deferred_files_.empty()) {
+    return 0;
+  }
+
+  vector<shared_ptr<FileInfo>> file_infos;
+  file_infos.swap(deferred_files_);
+  int res = namenode_client_->SetFiles(file_infos, true, deferred_responses_);
+  if (res < 0) {
+    deferred_count_ -= file_infos.size();
+  }
+  return res;
+}
+
+int CrailStore::WaitDeferred(vector<shared_ptr<VoidResponse>> &responses) {
+  int res = 0;
+  for (shared_ptr<VoidResponse> &response : responses) {
+    if (response->Get() < 0 || response->error() != 0) {
+      res = -1;
+    }
+    deferred_count_--;
+  }
+  return res;
+}
+
 unique_ptr<CrailNode> CrailStore::DispatchType(shared_ptr<FileInfo> file_info) {
   shared_ptr<BlockCache> file_block_cache = GetBlockCache(file_info->fd());
   if (file_info->type() == static_cast<int>(FileType::File)) {
@@ -164,20 +415,75 @@ unique_ptr<CrailNode> CrailStore::DispatchType(shared_ptr<FileInfo> file_info) {
 }
 
 shared_ptr<BlockCache> CrailStore::GetBlockCache(int fd) {
-  auto iter = block_cache_.find(fd);
-  if (iter != block_cache_.end()) {
-    return iter->second;
-  } else {
-    shared_ptr<BlockCache> cache = make_shared<BlockCache>(fd);
-    this->block_cache_.insert({fd, cache});
-    return cache;
+  BlockCacheShard &shard = block_cache_[(unsigned int)fd % kCacheShards];
+  lock_guard<mutex> guard(shard.lock);
+  auto iter = shard.caches.find(fd);
+  if (iter != shard.caches.end()) {
+    shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+    return *iter->second;
+  }
+
+  // streams still holding an evicted cache keep using it
+  while (shard.lru.size() >= kBlockCacheFiles / kCacheShards) {
+    shard.caches.erase(shard.lru.back()->fd());
+    shard.lru.pop_back();
+  }
+  shared_ptr<BlockCache> cache = make_shared<BlockCache>(fd);
+  shard.lru.push_front(cache);
+  shard.caches.insert({fd, shard.lru.begin()});
+  return cache;
+}
+
+void CrailStore::DropBlockCache(int fd) {
+  BlockCacheShard &shard = block_cache_[(unsigned int)fd % kCacheShards];
+  lock_guard<mutex> guard(shard.lock);
+  auto iter = shard.caches.find(fd);
+  if (iter != shard.caches.end()) {
+    shard.lru.erase(iter->second);
+    shard.caches.erase(iter);
+  }
+}
+
+int CrailStore::PrefetchBlocksSingle(shared_ptr<FileInfo> file_info,
+                                     unsigned long long position) {
+  // fallback for namenodes without range lookups, one request per block
+  unsigned long long capacity = file_info->capacity();
+  for (; position < capacity; position += kBlockSize) {
+    auto block_res = namenode_client_->GetBlock(
+        file_info->fd(), file_info->token(), position, 0);
+    if (!block_res) {
+      return -1;
+    }
+    if (block_res->Get() < 0 || block_res->error() != 0) {
+      return -1;
+    }
+    AddBlock(file_info->fd(), position, block_res->block_info());
   }
+  return 0;
+}
+
+int CrailStore::PrefetchBlocks(shared_ptr<FileInfo> file_info) {
+  unsigned long long position = kBlockSize;
+  unsigned long long capacity = file_info->capacity();
+  while (position < capacity) {
+    auto range_res = namenode_client_->GetBlockRange(
+        file_info->fd(), file_info->token(), position, capacity - position);
+    if (!range_res || range_res->Get() < 0 || range_res->error() != 0 ||
+        range_res->count() == 0) {
+      return PrefetchBlocksSingle(file_info, position);
+    }
+    for (int i = 0; i < range_res->count(); i++) {
+      AddBlock(file_info->fd(), position, range_res->block_info(i));
+      position += kBlockSize;
+    }
+  }
+  return 0;
 }
 
 int CrailStore::AddBlock(int fd, long long offset,
                          shared_ptr<BlockInfo> block) {
   shared_ptr<BlockCache> cache = GetBlockCache(fd);
-  cache->PutBlock(offset, block);
+  return cache->PutBlock(offset, block);
 }
 
 unique_ptr<CrailOutputstream>
@@ -190,17 +496,33 @@ CrailStore::DirectoryOuput(shared_ptr<FileInfo> file_info, long long position) {
 }
 
 int CrailStore::WriteDirectoryRecord(shared_ptr<FileInfo> parent_info,
-                                     string &fname, long long offset,
+                                     const string &fname, long long offset,
                                      int valid) {
+  vector<unique_ptr<CrailOutputstream>> streams;
+  if (IssueDirectoryRecord(parent_info, fname, offset, valid, streams) < 0) {
+    return -1;
+  }
+  if (streams.empty()) {
+    return 0;
+  }
+  return streams[0]->Sync();
+}
+
+int CrailStore::IssueDirectoryRecord(
+    shared_ptr<FileInfo> parent_info, const string &fname, long long offset,
+    int valid, vector<unique_ptr<CrailOutputstream>> &streams) {
   if (offset < 0) {
     return 0;
   }
 
   auto directory_stream = DirectoryOuput(parent_info, offset);
   DirectoryRecord record(valid, fname);
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(1024);
+  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(record.Size());
   record.Write(*buf);
   buf->Flip();
-  directory_stream->Write(buf);
+  if (directory_stream->Write(buf) < 0) {
+    return -1;
+  }
+  streams.push_back(move(directory_stream));
   return 0;
 }
@@ -24,12 +24,22 @@
 #ifndef CRAIL_STORE_H
 #define CRAIL_STORE_H
 
+#include <atomic>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include "common/crail_constants.h"
+#include "common/event_loop.h"
+#include "common/metadata_cache.h"
 #include "crail_inputstream.h"
 #include "crail_node.h"
 #include "crail_outputstream.h"
+#include "metadata/filename.h"
 #include "namenode/namenode_client.h"
 #include "storage/storage_cache.h"
 
@@ -47,24 +57,89 @@ public:
 
   int Initialize(string address, int port);
 
-  unique_ptr<CrailNode> Create(string &name, FileType type, int storage_class,
-                               int location_class, bool enumerable);
-  unique_ptr<CrailNode> Lookup(string &name);
-  int Remove(string &name, bool recursive);
-  int Ioctl(unsigned char op, string &name);
+  unique_ptr<CrailNode> Create(const string &name, FileType type,
+                               int storage_class, int location_class,
+                               bool enumerable);
+  unique_ptr<CrailNode> Lookup(const string &name);
+  // batched variants, failed entries are returned as nullptr
+  vector<unique_ptr<CrailNode>> Create(const vector<string> &names,
+                                       FileType type, int storage_class,
+                                       int location_class, bool enumerable);
+  vector<unique_ptr<CrailNode>> Lookup(const vector<string> &names);
+  int Remove(const string &name, bool recursive);
+  // removes all names with one namenode message, -1 if any of them failed
+  int Remove(const vector<string> &names, bool recursive);
+  int Ioctl(unsigned char op, const string &name);
+  // the SetFile of a deferred close is queued and sent in batches, it is
+  // completed by Flush, which also reports the first failed update
+  int CloseDeferred(unique_ptr<CrailOutputstream> outputstream);
+  int Flush();
+
+  void set_block_prefetch(unsigned long long block_prefetch) {
+    this->block_prefetch_ = block_prefetch;
+  }
+  unsigned long long block_prefetch() const { return block_prefetch_; }
+
+  void set_spin_time(int spin_time) { event_loop_->set_spin_time(spin_time); }
+  int spin_time() const { return event_loop_->spin_time(); }
+  void set_io_ring(bool io_ring) { event_loop_->set_io_ring(io_ring); }
+  bool io_ring() const { return event_loop_->io_ring(); }
+
+  void set_pool_size(int pool_size) { storage_cache_->set_pool_size(pool_size); }
+  int pool_size() const { return storage_cache_->pool_size(); }
+
+  // milliseconds lookup results and missing names are cached, 0 disables
+  void set_lookup_ttl(int ttl) { metadata_cache_.set_ttl(ttl); }
+  int lookup_ttl() const { return metadata_cache_.ttl(); }
+  void set_negative_ttl(int ttl) { metadata_cache_.set_negative_ttl(ttl); }
+  int negative_ttl() const { return metadata_cache_.negative_ttl(); }
 
 private:
   unique_ptr<CrailNode> DispatchType(shared_ptr<FileInfo> file_info);
+  unique_ptr<CrailNode> CompleteCreate(shared_ptr<CreateResponse> create_res,
+                                       const Filename &filename);
+  unique_ptr<CrailNode> CompleteLookup(shared_ptr<LookupResponse> lookup_res,
+                                       const string &name);
+  bool LookupCached(const string &name, unique_ptr<CrailNode> &node);
   shared_ptr<BlockCache> GetBlockCache(int fd);
+  void DropBlockCache(int fd);
   int AddBlock(int fd, long long offset, shared_ptr<BlockInfo> block);
+  int PrefetchBlocks(shared_ptr<FileInfo> file_info);
+  int PrefetchBlocksSingle(shared_ptr<FileInfo> file_info,
+                           unsigned long long position);
   unique_ptr<CrailOutputstream> DirectoryOuput(shared_ptr<FileInfo> file_info,
                                                long long position);
-  int WriteDirectoryRecord(shared_ptr<FileInfo> directory, string &fname,
-                           long long offset, int valid);
+  int WriteDirectoryRecord(shared_ptr<FileInfo> directory,
+                           const string &fname, long long offset, int valid);
+  int IssueDirectoryRecord(shared_ptr<FileInfo> directory,
+                           const string &fname, long long offset, int valid,
+                           vector<unique_ptr<CrailOutputstream>> &streams);
+  bool HasRemovedParent(const string &name,
+                        unordered_set<string> &removed_dirs);
+  // completes all queued updates, errors are kept for the next Flush
+  void DrainDeferred();
+  int SendDeferred();
+  int WaitDeferred(vector<shared_ptr<VoidResponse>> &responses);
 
+  shared_ptr<EventLoop> event_loop_;
   shared_ptr<NamenodeClient> namenode_client_;
   shared_ptr<StorageCache> storage_cache_;
-  unordered_map<int, shared_ptr<BlockCache>> block_cache_;
+  // per-file block caches, least recently used first out of the list
+  struct BlockCacheShard {
+    mutex lock;
+    list<shared_ptr<BlockCache>> lru;
+    unordered_map<int, list<shared_ptr<BlockCache>>::iterator> caches;
+  };
+  BlockCacheShard block_cache_[kCacheShards];
+  unsigned long long block_prefetch_;
+  MetadataCache metadata_cache_;
+  // deferred_lock_ guards the queued updates, the batch in flight and the
+  // first error not yet reported by Flush
+  mutex deferred_lock_;
+  atomic<int> deferred_count_;
+  vector<shared_ptr<FileInfo>> deferred_files_;
+  vector<shared_ptr<VoidResponse>> deferred_responses_;
+  int deferred_error_;
 };
 } // namespace crail
 
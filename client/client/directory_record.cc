@@ -27,31 +27,28 @@
 
 using namespace std;
 
-DirectoryRecord::DirectoryRecord() : valid_(-1) {
-  this->name_ = make_unique<string>("");
-}
+DirectoryRecord::DirectoryRecord() : valid_(-1) {}
 
-DirectoryRecord::DirectoryRecord(int valid, string &name)
-    : valid_(valid), name_(new string(name)) {}
+DirectoryRecord::DirectoryRecord(int valid, const string &name)
+    : valid_(valid), name_(name) {}
 
 DirectoryRecord::~DirectoryRecord() {}
 
 int DirectoryRecord::Write(ByteBuffer &buf) const {
-  int _length = name_->length();
+  int _length = name_.length();
   buf.PutInt(valid_);
   buf.PutInt(_length);
-  buf.PutBytes(name_->c_str(), name_->length());
+  buf.PutBytes(name_.c_str(), name_.length());
   return Size();
 }
 
 int DirectoryRecord::Update(ByteBuffer &buf) {
   this->valid_ = buf.GetInt();
   int _length = buf.GetInt();
-  char _tmp[_length + 1];
-  buf.GetBytes(_tmp, _length);
-  _tmp[_length] = '\0';
-  name_.reset(new string(_tmp));
+  // reuses the string's storage when a record is read into the same object
+  name_.assign((const char *)buf.get_bytes(), _length);
+  buf.set_position(buf.position() + _length);
   return Size();
 }
 
-int DirectoryRecord::Size() const { return sizeof(int) * 2 + name_->length(); }
+int DirectoryRecord::Size() const { return sizeof(int) * 2 + name_.length(); }
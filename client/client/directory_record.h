@@ -35,7 +35,7 @@ using namespace std;
 class DirectoryRecord : public Serializable {
 public:
   DirectoryRecord();
-  DirectoryRecord(int valid, string &name);
+  DirectoryRecord(int valid, const string &name);
   virtual ~DirectoryRecord();
 
   int Write(ByteBuffer &buf) const;
@@ -43,11 +43,11 @@ public:
   int Size() const;
 
   int valid() const { return valid_; };
-  string name() const { return *name_; };
+  const string &name() const { return name_; };
 
 private:
   int valid_;
-  unique_ptr<string> name_;
+  string name_;
 };
 
 #endif /* DIRECTORY_RECORD_H */
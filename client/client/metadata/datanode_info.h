@@ -48,7 +48,7 @@ public:
   int storage_class() const { return storage_class_; }
   int location_class() const { return location_class_; }
   int port() const { return port_; }
-  int addr() { return ip_address_; }
+  int addr() const { return ip_address_; }
 
 private:
   int storage_type_;
@@ -29,80 +29,50 @@
 #include <iterator>
 #include <math.h>
 #include <sstream>
+#include <string.h>
 #include <string>
 #include <vector>
 
 #include "utils/crail_hash.h"
+#include "utils/path_hash_cache.h"
 
 using namespace crail;
 
-Filename::Filename(string &name) {
-  int index_name = 1;
-  int index_comp = 0;
-  int name_start = index_name;
-  int name_stop = name_start;
-  while (index_name < name.length()) {
-    name_start = index_name;
-    int hash_code = file_hash(name, index_name);
-    name_stop = index_name - 1;
-    components_[index_comp] = hash_code;
-    index_comp++;
-    index_name++;
+Filename::Filename() : length_(0) {
+  for (int i = 0; i < kDirectoryDepth; i++) {
+    components_[i] = 0;
   }
-  this->length_ = index_comp;
-  this->name_ = name.substr(name_start, name_stop - name_start + 1);
-
-  /*
-char slash = '/';
-int start_index = 1;
-std::string::size_type pos = name.find(&slash, start_index);
-int index = 0;
-while (pos != std::string::npos) {
-int hash_code = 0;
-for (uint32_t i = start_index; i < pos; i++) {
-hash_code = 31 * hash_code + name[i];
-}
-components_[index] = hash_code;
-index++;
-start_index = pos + 1;
-}
-if (start_index < name.length()) {
-int hash_code = 0;
-for (uint32_t i = start_index; i < name.length(); i++) {
-hash_code = 31 * hash_code + name[i];
 }
-components_[index] = hash_code;
-index++;
-}
-length_ = index;
-while (index < kDirectoryDepth) {
-components_[index] = 0;
-index++;
-}
-  */
 
-  /*
-std::string token;
-std::stringstream tokenStream(name);
-int index = 0;
-while (std::getline(tokenStream, token, '/')) {
-if (token.empty()) {
-continue;
-}
-components_[index] = file_hash(token);
-name_ = token;
-index++;
-}
-length_ = index;
-while (index < kDirectoryDepth) {
-components_[index] = 0;
-index++;
-}
-  */
-}
+Filename::Filename(const string &name) { Set(name); }
 
 Filename::~Filename() {}
 
+void Filename::Set(const string &name) {
+  // same split as the Java client, a trailing '/' does not start a component
+  int end = name.length();
+  if (end > 1 && name[end - 1] == '/') {
+    end--;
+  }
+  const char *data = name.data();
+  const char *last_slash =
+      end > 1 ? (const char *)memrchr(data, '/', end) : nullptr;
+  if (!last_slash) {
+    length_ = 0;
+    name_.clear();
+  } else {
+    // the parent's hashes come from the cache, only the last one is computed
+    int slash = last_slash - data;
+    length_ = PathHashCache::ThreadCache().Hash(name, slash, components_);
+    int last = slash + 1;
+    components_[length_++] = file_hash(name.data() + last, end - last);
+    name_.assign(name, last, end - last);
+  }
+  for (int i = length_; i < kDirectoryDepth; i++) {
+    components_[i] = 0;
+  }
+}
+
 int Filename::Write(ByteBuffer &buf) const {
   buf.PutInt(length_);
   for (int i = 0; i < kDirectoryDepth; i++) {
@@ -120,4 +90,28 @@ int Filename::Update(ByteBuffer &buf) {
   return Size();
 }
 
+int Filename::WriteCompact(ByteBuffer &buf) const {
+  buf.PutInt(length_);
+  for (int i = 0; i < length_; i++) {
+    buf.PutInt(components_[i]);
+  }
+
+  return CompactSize();
+}
+
+int Filename::UpdateCompact(ByteBuffer &buf) {
+  length_ = buf.GetInt();
+  if (length_ < 0 || length_ > kDirectoryDepth) {
+    length_ = 0;
+    return -1;
+  }
+  for (int i = 0; i < length_; i++) {
+    components_[i] = buf.GetInt();
+  }
+  for (int i = length_; i < kDirectoryDepth; i++) {
+    components_[i] = 0;
+  }
+  return CompactSize();
+}
+
 int Filename::Size() const { return 4 + 16 * 4; }
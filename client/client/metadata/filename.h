@@ -37,15 +37,24 @@ namespace crail {
 
 class Filename : public Serializable {
 public:
-  Filename(string &name);
+  Filename();
+  Filename(const string &name);
   virtual ~Filename();
 
+  // parses a new name, a Filename can be reused across operations
+  void Set(const string &name);
+
   int Write(ByteBuffer &buf) const;
   int Update(ByteBuffer &buf);
   int Size() const;
 
+  // compact encoding, only the used components follow the length
+  int WriteCompact(ByteBuffer &buf) const;
+  int UpdateCompact(ByteBuffer &buf);
+  int CompactSize() const { return sizeof(int) * (length_ + 1); }
+
   int component() { return components_[length_ - 1]; }
-  string name() { return name_; }
+  const string &name() const { return name_; }
 
 private:
   int length_;
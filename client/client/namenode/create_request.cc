@@ -23,21 +23,20 @@
 
 #include "create_request.h"
 
-Createrequest::Createrequest(Filename &name, int type, int storage_class,
-                             int location_class, int enumerable)
+Createrequest::Createrequest(const Filename &name, int type,
+                             int storage_class, int location_class,
+                             int enumerable, short version)
     : NamenodeRequest(static_cast<short>(RpcCommand::Create),
-                      static_cast<short>(RequestType::Create)),
+                      static_cast<short>(RequestType::Create), version),
       filename_(name), type_(type), storage_class_(storage_class),
-      location_class_(location_class), enumerable_(enumerable) {
-  this->filename_ = std::move(name);
-}
+      location_class_(location_class), enumerable_(enumerable) {}
 
 Createrequest::~Createrequest() {}
 
 int Createrequest::Write(ByteBuffer &buf) const {
   NamenodeRequest::Write(buf);
 
-  filename_.Write(buf);
+  WriteFilename(buf, filename_);
   buf.PutInt(type_);
   buf.PutInt(storage_class_);
   buf.PutInt(location_class_);
@@ -49,7 +48,7 @@ int Createrequest::Write(ByteBuffer &buf) const {
 int Createrequest::Update(ByteBuffer &buf) {
   NamenodeRequest::Update(buf);
 
-  filename_.Update(buf);
+  UpdateFilename(buf, filename_);
   type_ = buf.GetInt();
   storage_class_ = buf.GetInt();
   location_class_ = buf.GetInt();
@@ -39,14 +39,16 @@ namespace crail {
 
 class Createrequest : public NamenodeRequest, public RpcMessage {
 public:
-  Createrequest(Filename &name, int type, int storage_class, int location_class,
-                int enumerable);
+  Createrequest(const Filename &name, int type, int storage_class,
+                int location_class, int enumerable,
+                short version = kProtocolLegacy);
   virtual ~Createrequest();
 
   shared_ptr<ByteBuffer> Payload() { return nullptr; }
 
   int Size() const {
-    return NamenodeRequest::Size() + filename_.Size() + 4 * sizeof(int);
+    return NamenodeRequest::Size() + FilenameSize(filename_) +
+           4 * sizeof(int);
   }
   int Write(ByteBuffer &buf) const;
   int Update(ByteBuffer &buf);
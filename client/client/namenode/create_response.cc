@@ -23,10 +23,13 @@
 
 #include "create_response.h"
 
+#include "common/pool_allocator.h"
+
 CreateResponse::CreateResponse(RpcClient *rpc_client)
-    : NamenodeResponse(rpc_client), file_info_(new FileInfo()),
-      parent_info_(new FileInfo()), file_block_(new BlockInfo()),
-      parent_block_(new BlockInfo()) {}
+    : NamenodeResponse(rpc_client), file_info_(MakePooled<FileInfo>()),
+      parent_info_(MakePooled<FileInfo>()),
+      file_block_(MakePooled<BlockInfo>()),
+      parent_block_(MakePooled<BlockInfo>()) {}
 
 CreateResponse::~CreateResponse() {}
 
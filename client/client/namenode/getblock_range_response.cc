@@ -0,0 +1,62 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "getblock_range_response.h"
+
+#include "common/pool_allocator.h"
+
+GetblockRangeResponse::GetblockRangeResponse(RpcClient *rpc_client)
+    : NamenodeResponse(rpc_client) {}
+
+GetblockRangeResponse::~GetblockRangeResponse() {}
+
+int GetblockRangeResponse::Write(ByteBuffer &buf) const {
+  NamenodeResponse::Write(buf);
+
+  buf.PutInt(blocks_.size());
+  for (const shared_ptr<BlockInfo> &block : blocks_) {
+    block->Write(buf);
+  }
+
+  return 0;
+}
+
+int GetblockRangeResponse::Update(ByteBuffer &buf) {
+  NamenodeResponse::Update(buf);
+
+  blocks_.clear();
+  if (error() != 0) {
+    return 0;
+  }
+  int count = buf.GetInt();
+  if (count < 0 || count > kMaxBlocks) {
+    count = 0;
+  }
+  for (int i = 0; i < count; i++) {
+    shared_ptr<BlockInfo> block = MakePooled<BlockInfo>();
+    block->Update(buf);
+    blocks_.push_back(block);
+  }
+
+  return 0;
+}
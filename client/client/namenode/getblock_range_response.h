@@ -0,0 +1,62 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GETBLOCK_RANGE_RESPONSE_H
+#define GETBLOCK_RANGE_RESPONSE_H
+
+#include <memory>
+#include <vector>
+
+#include "metadata/block_info.h"
+#include "namenode_response.h"
+#include "narpc/rpc_client.h"
+#include "narpc/rpc_message.h"
+
+using namespace std;
+
+class GetblockRangeResponse : public NamenodeResponse {
+public:
+  GetblockRangeResponse(RpcClient *rpc_client);
+  virtual ~GetblockRangeResponse();
+
+  // upper bound on blocks per response, matches GetBlockRangeRes.MAX_BLOCKS
+  static const int kMaxBlocks = 8;
+
+  shared_ptr<ByteBuffer> Payload() { return nullptr; }
+
+  int Size() const {
+    int block_size = blocks_.empty() ? 0 : blocks_[0]->Size();
+    return NamenodeResponse::Size() + sizeof(int) +
+           blocks_.size() * block_size;
+  }
+  int Write(ByteBuffer &buf) const;
+  int Update(ByteBuffer &buf);
+
+  int count() const { return blocks_.size(); }
+  shared_ptr<BlockInfo> block_info(int index) { return blocks_[index]; }
+
+private:
+  vector<shared_ptr<BlockInfo>> blocks_;
+};
+
+#endif /* GETBLOCK_RANGE_RESPONSE_H */
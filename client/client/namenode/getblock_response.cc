@@ -23,8 +23,10 @@
 
 #include "getblock_response.h"
 
+#include "common/pool_allocator.h"
+
 GetblockResponse::GetblockResponse(RpcClient *rpc_client)
-    : NamenodeResponse(rpc_client), block_info_(new BlockInfo()) {}
+    : NamenodeResponse(rpc_client), block_info_(MakePooled<BlockInfo>()) {}
 
 GetblockResponse::~GetblockResponse() {}
 
@@ -23,12 +23,11 @@
 
 #include "ioctl_request.h"
 
-IoctlRequest::IoctlRequest(unsigned char op, Filename &name)
+IoctlRequest::IoctlRequest(unsigned char op, const Filename &name)
     : NamenodeRequest(static_cast<short>(RpcCommand::Ioctl),
                       static_cast<short>(RequestType::Ioctl)),
       filename_(name) {
   this->op_ = op;
-  this->filename_ = std::move(name);
 }
 
 IoctlRequest::~IoctlRequest() {}
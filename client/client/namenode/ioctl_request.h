@@ -34,7 +34,7 @@ using namespace crail;
 
 class IoctlRequest : public NamenodeRequest, public RpcMessage {
 public:
-  IoctlRequest(unsigned char op, Filename &name);
+  IoctlRequest(unsigned char op, const Filename &name);
   virtual ~IoctlRequest();
 
   shared_ptr<ByteBuffer> Payload() { return nullptr; }
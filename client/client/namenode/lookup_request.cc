@@ -23,18 +23,16 @@
 
 #include "lookup_request.h"
 
-LookupRequest::LookupRequest(Filename &name)
+LookupRequest::LookupRequest(const Filename &name, short version)
     : NamenodeRequest(static_cast<short>(RpcCommand::Lookup),
-                      static_cast<short>(RequestType::Lookup)),
-      filename_(name) {
-  this->filename_ = std::move(name);
-}
+                      static_cast<short>(RequestType::Lookup), version),
+      filename_(name) {}
 LookupRequest::~LookupRequest() {}
 
 int LookupRequest::Write(ByteBuffer &buf) const {
   NamenodeRequest::Write(buf);
 
-  filename_.Write(buf);
+  WriteFilename(buf, filename_);
   buf.PutInt(0);
 
   return Size();
@@ -43,7 +41,7 @@ int LookupRequest::Write(ByteBuffer &buf) const {
 int LookupRequest::Update(ByteBuffer &buf) {
   NamenodeRequest::Update(buf);
 
-  filename_.Update(buf);
+  UpdateFilename(buf, filename_);
   buf.GetInt();
 
   return Size();
@@ -34,13 +34,13 @@ using namespace std;
 
 class LookupRequest : public NamenodeRequest, public RpcMessage {
 public:
-  LookupRequest(Filename &name);
+  LookupRequest(const Filename &name, short version = kProtocolLegacy);
   virtual ~LookupRequest();
 
   shared_ptr<ByteBuffer> Payload() { return nullptr; }
 
   int Size() const {
-    return NamenodeRequest::Size() + filename_.Size() + sizeof(int);
+    return NamenodeRequest::Size() + FilenameSize(filename_) + sizeof(int);
   }
   int Write(ByteBuffer &buf) const;
   int Update(ByteBuffer &buf);
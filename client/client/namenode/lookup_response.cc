@@ -25,11 +25,13 @@
 
 #include <iostream>
 
+#include "common/pool_allocator.h"
+
 using namespace std;
 
 LookupResponse::LookupResponse(RpcClient *rpc_client)
-    : NamenodeResponse(rpc_client), file_info_(new FileInfo()),
-      block_info_(new BlockInfo()) {}
+    : NamenodeResponse(rpc_client), file_info_(MakePooled<FileInfo>()),
+      block_info_(MakePooled<BlockInfo>()) {}
 
 LookupResponse::~LookupResponse() {}
 
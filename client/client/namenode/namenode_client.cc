@@ -33,38 +33,72 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "common/pool_allocator.h"
 #include "crail_store.h"
 #include "create_request.h"
 #include "create_response.h"
+#include "getblock_range_request.h"
+#include "getblock_range_response.h"
 #include "getblock_request.h"
 #include "getblock_response.h"
 #include "ioctl_request.h"
 #include "lookup_request.h"
+#include "ping_request.h"
 #include "remove_request.h"
 #include "setfile_request.h"
 
-NamenodeClient::NamenodeClient() : RpcClient(NamenodeClient::kNodelay) {
+NamenodeClient::NamenodeClient(shared_ptr<EventLoop> event_loop)
+    : RpcClient(NamenodeClient::kNodelay, event_loop) {
   this->counter_ = 1;
+  this->version_ = kProtocolLegacy;
 }
 
 NamenodeClient::~NamenodeClient() {}
 
-shared_ptr<CreateResponse> NamenodeClient::Create(Filename &name, int type,
-                                                  int storage_class,
+int NamenodeClient::Connect(int address, int port) {
+  if (RpcClient::Connect(address, port) < 0) {
+    return -1;
+  }
+  return Negotiate();
+}
+
+int NamenodeClient::Negotiate() {
+  this->version_ = kProtocolLegacy;
+  if (!kCompactFilename) {
+    return 0;
+  }
+
+  shared_ptr<PingResponse> ping_res = Ping(kPingProtocolProbe);
+  if (!ping_res || ping_res->Get() < 0) {
+    cout << "protocol negotiation with namenode failed" << endl;
+    return -1;
+  }
+  // namenodes that predate the versioned protocol just echo op + 1
+  int version = ping_res->data() - kPingProtocolProbe - 1;
+  if (ping_res->error() == 0 && version >= kProtocolCompactFilename) {
+    this->version_ = kProtocolCompactFilename;
+  }
+  return 0;
+}
+
+shared_ptr<CreateResponse> NamenodeClient::Create(const Filename &name,
+                                                  int type, int storage_class,
                                                   int location_class,
                                                   int enumerable) {
   Createrequest createReq(name, type, storage_class, location_class,
-                          enumerable);
-  shared_ptr<CreateResponse> getblockRes = make_shared<CreateResponse>(this);
+                          enumerable, version_);
+  shared_ptr<CreateResponse> getblockRes = MakePooled<CreateResponse>(this);
+  getblockRes->Track(Stat::NamenodeCreate, 0);
   if (RpcClient::IssueRequest(createReq, getblockRes) < 0) {
     return nullptr;
   }
   return getblockRes;
 }
 
-shared_ptr<LookupResponse> NamenodeClient::Lookup(Filename &name) {
-  LookupRequest lookupReq(name);
-  shared_ptr<LookupResponse> lookupRes = make_shared<LookupResponse>(this);
+shared_ptr<LookupResponse> NamenodeClient::Lookup(const Filename &name) {
+  LookupRequest lookupReq(name, version_);
+  shared_ptr<LookupResponse> lookupRes = MakePooled<LookupResponse>(this);
+  lookupRes->Track(Stat::NamenodeLookup, 0);
   if (RpcClient::IssueRequest(lookupReq, lookupRes) < 0) {
     return nullptr;
   }
@@ -77,37 +111,108 @@ shared_ptr<GetblockResponse> NamenodeClient::GetBlock(long long fd,
                                                       long long capacity) {
   GetblockRequest get_block_req(fd, token, position, capacity);
   shared_ptr<GetblockResponse> get_block_res =
-      make_shared<GetblockResponse>(this);
+      MakePooled<GetblockResponse>(this);
+  get_block_res->Track(Stat::NamenodeGetBlock, 0);
   if (RpcClient::IssueRequest(get_block_req, get_block_res) < 0) {
     return nullptr;
   }
   return get_block_res;
 }
 
+shared_ptr<GetblockRangeResponse>
+NamenodeClient::GetBlockRange(long long fd, long long token, long long position,
+                              long long length) {
+  GetblockRangeRequest get_block_range_req(fd, token, position, length);
+  shared_ptr<GetblockRangeResponse> get_block_range_res =
+      MakePooled<GetblockRangeResponse>(this);
+  get_block_range_res->Track(Stat::NamenodeGetBlockRange, 0);
+  if (RpcClient::IssueRequest(get_block_range_req, get_block_range_res) < 0) {
+    return nullptr;
+  }
+  return get_block_range_res;
+}
+
 shared_ptr<VoidResponse> NamenodeClient::SetFile(shared_ptr<FileInfo> file_info,
                                                  bool close) {
   SetfileRequest set_file_req(file_info, close);
-  shared_ptr<VoidResponse> set_file_res = make_shared<VoidResponse>(this);
+  shared_ptr<VoidResponse> set_file_res = MakePooled<VoidResponse>(this);
+  set_file_res->Track(Stat::NamenodeSetFile, 0);
   if (RpcClient::IssueRequest(set_file_req, set_file_res) < 0) {
     return nullptr;
   }
   return set_file_res;
 }
 
-shared_ptr<RemoveResponse> NamenodeClient::Remove(Filename &name,
+int NamenodeClient::SetFiles(vector<shared_ptr<FileInfo>> &file_infos,
+                             bool close,
+                             vector<shared_ptr<VoidResponse>> &set_file_res) {
+  unsigned original = set_file_res.size();
+  vector<SetfileRequest> requests;
+  vector<RpcMessage *> messages;
+  vector<shared_ptr<RpcResponse>> responses;
+  requests.reserve(file_infos.size());
+  for (shared_ptr<FileInfo> &file_info : file_infos) {
+    requests.emplace_back(file_info, close);
+    messages.push_back(&requests.back());
+    shared_ptr<VoidResponse> response = MakePooled<VoidResponse>(this);
+    response->Track(Stat::NamenodeSetFile, 0);
+    responses.push_back(response);
+    set_file_res.push_back(response);
+  }
+  if (RpcClient::IssueRequests(messages, responses) < 0) {
+    set_file_res.resize(original);
+    return -1;
+  }
+  return 0;
+}
+
+shared_ptr<RemoveResponse> NamenodeClient::Remove(const Filename &name,
                                                   bool recursive) {
-  RemoveRequest remove_req(name, recursive);
-  shared_ptr<RemoveResponse> remove_res = make_shared<RemoveResponse>(this);
+  RemoveRequest remove_req(name, recursive, version_);
+  shared_ptr<RemoveResponse> remove_res = MakePooled<RemoveResponse>(this);
+  remove_res->Track(Stat::NamenodeRemove, 0);
   if (RpcClient::IssueRequest(remove_req, remove_res) < 0) {
     return nullptr;
   }
   return remove_res;
 }
 
+int NamenodeClient::Remove(vector<Filename> &names, bool recursive,
+                           vector<shared_ptr<RemoveResponse>> &remove_res) {
+  unsigned original = remove_res.size();
+  vector<RemoveRequest> requests;
+  vector<RpcMessage *> messages;
+  vector<shared_ptr<RpcResponse>> responses;
+  requests.reserve(names.size());
+  for (const Filename &name : names) {
+    requests.emplace_back(name, recursive, version_);
+    messages.push_back(&requests.back());
+    shared_ptr<RemoveResponse> response = MakePooled<RemoveResponse>(this);
+    response->Track(Stat::NamenodeRemove, 0);
+    responses.push_back(response);
+    remove_res.push_back(response);
+  }
+  if (RpcClient::IssueRequests(messages, responses) < 0) {
+    remove_res.resize(original);
+    return -1;
+  }
+  return 0;
+}
+
+shared_ptr<PingResponse> NamenodeClient::Ping(int op) {
+  PingRequest ping_req(op);
+  shared_ptr<PingResponse> ping_res = MakePooled<PingResponse>(this);
+  if (RpcClient::IssueRequest(ping_req, ping_res) < 0) {
+    return nullptr;
+  }
+  return ping_res;
+}
+
 shared_ptr<IoctlResponse> NamenodeClient::Ioctl(unsigned char op,
-                                                Filename &name) {
+                                                const Filename &name) {
   IoctlRequest ioctl_request(op, name);
-  shared_ptr<IoctlResponse> ioctl_response = make_shared<IoctlResponse>(this);
+  shared_ptr<IoctlResponse> ioctl_response = MakePooled<IoctlResponse>(this);
+  ioctl_response->Track(Stat::NamenodeIoctl, 0);
   if (RpcClient::IssueRequest(ioctl_request, ioctl_response) < 0) {
     return nullptr;
   }
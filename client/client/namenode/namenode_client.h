@@ -26,34 +26,54 @@
 
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include "create_response.h"
+#include "getblock_range_response.h"
 #include "getblock_response.h"
 #include "ioctl_response.h"
 #include "lookup_response.h"
 #include "metadata/filename.h"
 #include "narpc/rpc_client.h"
+#include "ping_response.h"
 #include "remove_response.h"
 #include "void_response.h"
 
 class NamenodeClient : public RpcClient {
 public:
-  NamenodeClient();
+  NamenodeClient(shared_ptr<EventLoop> event_loop);
   virtual ~NamenodeClient();
 
   static const bool kNodelay = true;
 
-  shared_ptr<CreateResponse> Create(Filename &name, int type, int storage_class,
-                                    int location_class, int enumerable);
-  shared_ptr<LookupResponse> Lookup(Filename &name);
+  // connects and agrees on the protocol version with the namenode
+  int Connect(int address, int port);
+  shared_ptr<PingResponse> Ping(int op);
+
+  shared_ptr<CreateResponse> Create(const Filename &name, int type,
+                                    int storage_class, int location_class,
+                                    int enumerable);
+  shared_ptr<LookupResponse> Lookup(const Filename &name);
   shared_ptr<GetblockResponse> GetBlock(long long fd, long long token,
                                         long long position, long long capacity);
+  shared_ptr<GetblockRangeResponse> GetBlockRange(long long fd, long long token,
+                                                  long long position,
+                                                  long long length);
   shared_ptr<VoidResponse> SetFile(shared_ptr<FileInfo> file_info, bool close);
-  shared_ptr<RemoveResponse> Remove(Filename &name, bool recursive);
-  shared_ptr<IoctlResponse> Ioctl(unsigned char op, Filename &name);
+  // sends all updates in one message, a response is appended per file
+  // unless the send fails
+  int SetFiles(vector<shared_ptr<FileInfo>> &file_infos, bool close,
+               vector<shared_ptr<VoidResponse>> &set_file_res);
+  shared_ptr<RemoveResponse> Remove(const Filename &name, bool recursive);
+  int Remove(vector<Filename> &names, bool recursive,
+             vector<shared_ptr<RemoveResponse>> &remove_res);
+  shared_ptr<IoctlResponse> Ioctl(unsigned char op, const Filename &name);
 
 private:
+  int Negotiate();
+
   atomic<unsigned long long> counter_;
+  short version_;
 };
 
 #endif /* NAMENODE_CLIENT_H */
@@ -23,21 +23,47 @@
 
 #include "namenode_request.h"
 
-NamenodeRequest::NamenodeRequest(short cmd, short type)
-    : cmd_(cmd), type_(type) {}
+NamenodeRequest::NamenodeRequest(short cmd, short type, short version)
+    : cmd_(cmd), type_(type), version_(version) {}
 
 NamenodeRequest::~NamenodeRequest() {}
 
 int NamenodeRequest::Write(ByteBuffer &buf) const {
   buf.PutShort(cmd_);
-  buf.PutShort(type_);
+  buf.PutShort(type_ | (version_ << 8));
 
   return Size();
 }
 
 int NamenodeRequest::Update(ByteBuffer &buf) {
   this->cmd_ = buf.GetShort();
-  this->type_ = buf.GetShort();
+  unsigned short type = buf.GetShort();
+  this->type_ = type & 0xff;
+  this->version_ = type >> 8;
 
   return Size();
 }
+
+int NamenodeRequest::FilenameSize(const Filename &name) const {
+  if (version_ >= kProtocolCompactFilename) {
+    return name.CompactSize();
+  }
+  return name.Size();
+}
+
+void NamenodeRequest::WriteFilename(ByteBuffer &buf,
+                                    const Filename &name) const {
+  if (version_ >= kProtocolCompactFilename) {
+    name.WriteCompact(buf);
+  } else {
+    name.Write(buf);
+  }
+}
+
+void NamenodeRequest::UpdateFilename(ByteBuffer &buf, Filename &name) {
+  if (version_ >= kProtocolCompactFilename) {
+    name.UpdateCompact(buf);
+  } else {
+    name.Update(buf);
+  }
+}
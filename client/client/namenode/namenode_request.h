@@ -25,7 +25,9 @@
 #define NAMENODE_REQUEST_H
 
 #include "common/byte_buffer.h"
+#include "common/crail_constants.h"
 #include "common/serializable.h"
+#include "metadata/filename.h"
 
 using namespace crail;
 
@@ -35,7 +37,9 @@ enum class RpcCommand : short {
   Setfile = 3,
   Removefile = 4,
   Getblock = 6,
+  Ping = 11,
   Ioctl = 13,
+  GetblockRange = 15,
 };
 enum class RequestType : short {
   Create = 1,
@@ -43,21 +47,32 @@ enum class RequestType : short {
   Setfile = 3,
   Removefile = 4,
   Getblock = 6,
-  Ioctl = 13
+  Ping = 11,
+  Ioctl = 13,
+  GetblockRange = 15
 };
 
 class NamenodeRequest : public Serializable {
 public:
-  NamenodeRequest(short cmd, short type);
+  NamenodeRequest(short cmd, short type, short version = kProtocolLegacy);
   virtual ~NamenodeRequest();
 
   int Write(ByteBuffer &buf) const;
   int Update(ByteBuffer &buf);
   int Size() const { return sizeof(short) * 2; }
 
+  short version() const { return version_; }
+
+protected:
+  // filenames are encoded according to the version of the request
+  int FilenameSize(const Filename &name) const;
+  void WriteFilename(ByteBuffer &buf, const Filename &name) const;
+  void UpdateFilename(ByteBuffer &buf, Filename &name);
+
 private:
   short cmd_;
   short type_;
+  short version_;
 };
 
 #endif /* NAMENODE_REQUEST_H */
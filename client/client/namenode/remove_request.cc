@@ -23,11 +23,11 @@
 
 #include "remove_request.h"
 
-RemoveRequest::RemoveRequest(Filename &name, bool recursive)
+RemoveRequest::RemoveRequest(const Filename &name, bool recursive,
+                             short version)
     : NamenodeRequest(static_cast<short>(RpcCommand::Removefile),
-                      static_cast<short>(RequestType::Removefile)),
+                      static_cast<short>(RequestType::Removefile), version),
       filename_(name) {
-  this->filename_ = std::move(name);
   this->recursive_ = recursive;
 }
 RemoveRequest::~RemoveRequest() {}
@@ -35,7 +35,7 @@ RemoveRequest::~RemoveRequest() {}
 int RemoveRequest::Write(ByteBuffer &buf) const {
   NamenodeRequest::Write(buf);
 
-  filename_.Write(buf);
+  WriteFilename(buf, filename_);
   int recursive = this->recursive_ ? 1 : 0;
   buf.PutInt(recursive);
 
@@ -45,7 +45,7 @@ int RemoveRequest::Write(ByteBuffer &buf) const {
 int RemoveRequest::Update(ByteBuffer &buf) {
   NamenodeRequest::Update(buf);
 
-  filename_.Update(buf);
+  UpdateFilename(buf, filename_);
   buf.GetInt();
 
   return Size();
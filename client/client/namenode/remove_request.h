@@ -32,13 +32,14 @@
 
 class RemoveRequest : public NamenodeRequest, public RpcMessage {
 public:
-  RemoveRequest(Filename &name, bool recursive);
+  RemoveRequest(const Filename &name, bool recursive,
+                short version = kProtocolLegacy);
   virtual ~RemoveRequest();
 
   shared_ptr<ByteBuffer> Payload() { return nullptr; }
 
   int Size() const {
-    return NamenodeRequest::Size() + filename_.Size() + sizeof(int);
+    return NamenodeRequest::Size() + FilenameSize(filename_) + sizeof(int);
   }
   int Write(ByteBuffer &buf) const;
   int Update(ByteBuffer &buf);
@@ -23,9 +23,11 @@
 
 #include "remove_response.h"
 
+#include "common/pool_allocator.h"
+
 RemoveResponse::RemoveResponse(RpcClient *rpc_client)
-    : NamenodeResponse(rpc_client), file_info_(new FileInfo()),
-      parent_info_(new FileInfo()) {}
+    : NamenodeResponse(rpc_client), file_info_(MakePooled<FileInfo>()),
+      parent_info_(MakePooled<FileInfo>()) {}
 
 RemoveResponse::~RemoveResponse() {}
 
@@ -24,9 +24,11 @@
 #ifndef RPC_CHECKER_H
 #define RPC_CHECKER_H
 
+class RpcResponse;
+
 class RpcChecker {
 public:
-  virtual int PollResponse() = 0;
+  virtual int WaitResponse(RpcResponse *response) = 0;
 
 private:
 };
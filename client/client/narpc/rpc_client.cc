@@ -27,6 +27,7 @@
 #include <errno.h>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <sstream>
@@ -43,7 +44,9 @@
 using namespace std;
 using namespace crail;
 
-RpcClient::RpcClient(bool nodelay) : isConnected(false), buf_(1024) {
+RpcClient::RpcClient(bool nodelay, shared_ptr<EventLoop> event_loop)
+    : isConnected(false), send_buf_(1024 * kMaxBatch), recv_buf_(1024),
+      event_loop_(event_loop) {
   this->socket_ = socket(AF_INET, SOCK_STREAM, 0);
   this->counter_ = 1;
   this->nodelay_ = nodelay;
@@ -56,6 +59,11 @@ int RpcClient::Connect(int address, int port) {
     return 0;
   }
 
+  lock_guard<mutex> guard(send_lock_);
+  if (isConnected) {
+    return 0;
+  }
+
   this->address_ = address;
   this->port_ = port;
 
@@ -79,12 +87,15 @@ int RpcClient::Connect(int address, int port) {
   } else {
     cout << "connected to " << addressport << endl;
   }
+  event_loop_->Register(socket_);
   isConnected = true;
   return 0;
 }
 
 int RpcClient::Close() {
+  lock_guard<mutex> guard(send_lock_);
   if (isConnected) {
+    event_loop_->Unregister(socket_);
     close(socket_);
     isConnected = false;
   }
@@ -93,55 +104,158 @@ int RpcClient::Close() {
 
 int RpcClient::IssueRequest(RpcMessage &request,
                             shared_ptr<RpcResponse> response) {
-  unsigned long long ticket = counter_++ % RpcClient::kMaxTicket;
-  if (ticket == 0) {
-    ticket++;
+  if (Throttle(1) < 0) {
+    return -1;
   }
-  responseMap_[ticket] = response;
-  buf_.Clear();
+
+  // the ticket is registered before sending, the reply may be picked up by
+  // another thread before the send returns
+  unsigned long long ticket = AddTicket(response);
+
+  lock_guard<mutex> guard(send_lock_);
+  send_buf_.Clear();
 
   // narpc header (size, ticket)
-  AddNaRPCHeader(buf_, request.Size(), ticket);
+  AddNaRPCHeader(send_buf_, request.Size(), ticket);
   // create file request
-  request.Write(buf_);
-
-  // issue request
-  buf_.Flip();
-  // int _metadata = buf_.remaining();
-  if (SendBytes(buf_.get_bytes(), buf_.remaining()) < 0) {
+  request.Write(send_buf_);
+
+  // issue header and payload with a single gather send
+  send_buf_.Flip();
+  struct iovec iov[2];
+  iov[0].iov_base = send_buf_.get_bytes();
+  iov[0].iov_len = send_buf_.remaining();
+  iov[1].iov_base = nullptr;
+  iov[1].iov_len = 0;
+  shared_ptr<ByteBuffer> payload = request.Payload();
+  if (payload) {
+    iov[1].iov_base = payload->get_bytes();
+    iov[1].iov_len = payload->remaining();
+  }
+  if (SendVector(socket_, iov, 2) < 0) {
     cout << "Error when sending rpc message " << endl;
+    lock_guard<mutex> map_guard(map_lock_);
+    responseMap_.erase(ticket);
     return -1;
   }
 
-  shared_ptr<ByteBuffer> payload = request.Payload();
-  // int _data = 0;
-  if (payload) {
-    //_data = payload->remaining();
-    if (SendBytes(payload->get_bytes(), payload->remaining()) < 0) {
-      cout << "Error when sending RPC payload" << endl;
+  return 0;
+}
+
+int RpcClient::IssueRequests(vector<RpcMessage *> &requests,
+                             vector<shared_ptr<RpcResponse>> &responses) {
+  for (unsigned start = 0; start < requests.size(); start += kMaxBatch) {
+    int count = requests.size() - start;
+    if (count > kMaxBatch) {
+      count = kMaxBatch;
+    }
+    if (Throttle(count) < 0) {
+      return -1;
+    }
+
+    unsigned long long tickets[kMaxBatch];
+    for (int i = 0; i < count; i++) {
+      tickets[i] = AddTicket(responses[start + i]);
+    }
+
+    // all frames of the batch leave with a single gather send
+    lock_guard<mutex> guard(send_lock_);
+    send_buf_.Clear();
+    struct iovec iov[2 * kMaxBatch];
+    int iov_count = 0;
+    for (int i = 0; i < count; i++) {
+      RpcMessage *request = requests[start + i];
+      unsigned char *frame = send_buf_.get_bytes();
+      int offset = send_buf_.position();
+      AddNaRPCHeader(send_buf_, request->Size(), tickets[i]);
+      request->Write(send_buf_);
+      iov[iov_count].iov_base = frame;
+      iov[iov_count].iov_len = send_buf_.position() - offset;
+      iov_count++;
+      shared_ptr<ByteBuffer> payload = request->Payload();
+      if (payload) {
+        iov[iov_count].iov_base = payload->get_bytes();
+        iov[iov_count].iov_len = payload->remaining();
+        iov_count++;
+      }
+    }
+    if (SendVector(socket_, iov, iov_count) < 0) {
+      cout << "Error when sending rpc message " << endl;
+      lock_guard<mutex> map_guard(map_lock_);
+      for (int i = 0; i < count; i++) {
+        responseMap_.erase(tickets[i]);
+      }
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+int RpcClient::Throttle(int count) {
+  // bound the number of outstanding requests
+  while (inflight() + count > RpcClient::kMaxInflight) {
+    lock_guard<mutex> guard(recv_lock_);
+    if (inflight() + count > RpcClient::kMaxInflight && PollResponse() < 0) {
       return -1;
     }
   }
+  return 0;
+}
 
-  // int _total = _metadata + _data;
-  // cout << "transmitting message, port " << port_ << ", size " << _total <<
-  // endl;
+unsigned long long RpcClient::AddTicket(shared_ptr<RpcResponse> response) {
+  lock_guard<mutex> guard(map_lock_);
+  unsigned long long ticket = counter_++;
+  while (ticket == 0 || responseMap_.count(ticket) > 0) {
+    ticket = counter_++;
+  }
+  responseMap_.insert({ticket, response});
+  return ticket;
+}
 
+int RpcClient::WaitResponse(RpcResponse *response) {
+  // whichever thread holds the receive lock reads replies for everybody
+  lock_guard<mutex> guard(recv_lock_);
+  while (!response->is_done()) {
+    if (PollResponse() < 0) {
+      return -1;
+    }
+  }
   return 0;
 }
 
+int RpcClient::inflight() const {
+  lock_guard<mutex> guard(map_lock_);
+  return responseMap_.size();
+}
+
 int RpcClient::PollResponse() {
   // recv resp header
-  buf_.Clear();
-  if (RecvBytes(buf_.get_bytes(), kNarpcHeader) < 0) {
+  recv_buf_.Clear();
+  if (RecvBytes(recv_buf_.get_bytes(), kNarpcHeader) < 0) {
     cout << "Error receiving rpc header" << endl;
     return -1;
   }
-  int size = buf_.GetInt();
-  long long ticket = buf_.GetLong();
-
-  shared_ptr<RpcMessage> response = responseMap_[ticket];
-  responseMap_[ticket] = nullptr;
+  int size = recv_buf_.GetInt();
+  unsigned long long ticket = recv_buf_.GetLong();
+
+  shared_ptr<RpcResponse> response = nullptr;
+  {
+    lock_guard<mutex> guard(map_lock_);
+    auto iter = responseMap_.find(ticket);
+    if (iter != responseMap_.end()) {
+      response = iter->second;
+      responseMap_.erase(iter);
+    }
+  }
+  if (!response) {
+    // a late reply nobody waits for is skipped, it must not fail the caller
+    if (DrainBytes(size) < 0) {
+      cout << "Error receiving rpc message" << endl;
+      return -1;
+    }
+    return 0;
+  }
 
   shared_ptr<ByteBuffer> payload = response->Payload();
   int payload_size = 0;
@@ -149,28 +263,31 @@ int RpcClient::PollResponse() {
     payload_size = payload->remaining();
   }
 
-  // recv resp obj
-  buf_.Clear();
+  // recv resp obj and payload with a single scatter receive
+  recv_buf_.Clear();
   int header_size = size - payload_size;
-  if (RecvBytes(buf_.get_bytes(), header_size) < 0) {
+  struct iovec iov[2];
+  iov[0].iov_base = recv_buf_.get_bytes();
+  iov[0].iov_len = header_size;
+  iov[1].iov_base = nullptr;
+  iov[1].iov_len = 0;
+  if (payload) {
+    iov[1].iov_base = payload->get_bytes();
+    iov[1].iov_len = payload_size;
+  }
+  if (RecvVector(socket_, iov, 2, event_loop_.get()) < 0) {
     cout << "Error receiving rpc message" << endl;
     return -1;
   }
 
-  response->Update(buf_);
-
-  if (payload) {
-    if (RecvBytes(payload->get_bytes(), payload->remaining()) < 0) {
-      cout << "Error receiving rpc payload" << endl;
-      return -1;
-    }
-  }
+  response->Update(recv_buf_);
+  response->set_done();
 
   // int _total = kNarpcHeader + size;
   // cout << "receiving message, port " << port_ << ", size " << _total << endl;
 
   /*
-int extra = recv(socket_, buf_.get_bytes(), 1, MSG_DONTWAIT);
+int extra = recv(socket_, recv_buf_.get_bytes(), 1, MSG_DONTWAIT);
 if (extra > 0) {
 cout << "reading extra data! " << endl;
 return -1;
@@ -192,38 +309,21 @@ long long RpcClient::RemoveNaRPCHeader(ByteBuffer &buf) {
   return ticket;
 }
 
-int RpcClient::SendBytes(unsigned char *buf, int size) {
-  int res = send(socket_, buf, (size_t)size, (int)0);
-  if (res < 0) {
-    return res;
-  }
-  int remaining = size - res;
-  while (remaining > 0) {
-    int offset = size - remaining;
-    res = send(socket_, buf + offset, (size_t)remaining, (int)0);
-    if (res < 0) {
-      return res;
+int RpcClient::DrainBytes(int size) {
+  while (size > 0) {
+    int chunk = size < recv_buf_.size() ? size : recv_buf_.size();
+    recv_buf_.Clear();
+    if (RecvBytes(recv_buf_.get_bytes(), chunk) < 0) {
+      return -1;
     }
-    remaining -= res;
+    size -= chunk;
   }
-  return remaining;
+  return 0;
 }
 
 int RpcClient::RecvBytes(unsigned char *buf, int size) {
-  int sum = 0;
-  while (sum < size) {
-    int res = recv(socket_, buf + sum, (size_t)(size - sum), MSG_DONTWAIT);
-
-    if (res < 0) {
-      if (errno == EAGAIN) {
-        continue;
-      }
-      // return res;
-      break;
-    }
-
-    sum += res;
-  }
-
-  return sum != size ? -1 : 0;
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = size;
+  return RecvVector(socket_, &iov, 1, event_loop_.get());
 }
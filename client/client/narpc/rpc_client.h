@@ -26,6 +26,7 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <stdio.h>
@@ -36,8 +37,11 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <unordered_map>
+#include <vector>
 
 #include "common/byte_buffer.h"
+#include "common/event_loop.h"
+#include "common/pool_allocator.h"
 #include "common/serializable.h"
 #include "rpc_checker.h"
 #include "rpc_message.h"
@@ -50,31 +54,51 @@ namespace crail {
 
 class RpcClient : public RpcChecker {
 public:
-  RpcClient(bool nodelay);
+  RpcClient(bool nodelay, shared_ptr<EventLoop> event_loop);
   virtual ~RpcClient();
 
   static const int kNarpcHeader = 12;
   static const int kRpcHeader = 4;
-  static const int kMaxTicket = 8;
+  static const int kMaxInflight = 1024;
+  static const int kMaxBatch = 16;
 
   int Connect(int address, int port);
   int IssueRequest(RpcMessage &request, shared_ptr<RpcResponse> response);
+  int IssueRequests(vector<RpcMessage *> &requests,
+                    vector<shared_ptr<RpcResponse>> &responses);
   int Close();
 
+  int WaitResponse(RpcResponse *response);
+  int inflight() const;
+
 private:
   int PollResponse();
+  int Throttle(int count);
+  unsigned long long AddTicket(shared_ptr<RpcResponse> response);
+  int DrainBytes(int size);
 
-  int SendBytes(unsigned char *buf, int size);
   int RecvBytes(unsigned char *buf, int size);
   void AddNaRPCHeader(ByteBuffer &buf, int size, unsigned long long ticket);
   long long RemoveNaRPCHeader(ByteBuffer &buf);
 
   int socket_;
   atomic<unsigned long long> counter_;
-  shared_ptr<RpcMessage> responseMap_[kMaxTicket];
-  bool isConnected;
-  ByteBuffer buf_;
+  // ticket table nodes are recycled, one is taken and returned per request
+  unordered_map<unsigned long long, shared_ptr<RpcResponse>,
+                hash<unsigned long long>, equal_to<unsigned long long>,
+                PoolAllocator<
+                    pair<const unsigned long long, shared_ptr<RpcResponse>>>>
+      responseMap_;
+  atomic<bool> isConnected;
+  // send_lock_ serializes senders on send_buf_, recv_lock_ elects the one
+  // thread reading the socket, map_lock_ guards the ticket table
+  mutex send_lock_;
+  mutex recv_lock_;
+  mutable mutex map_lock_;
+  ByteBuffer send_buf_;
+  ByteBuffer recv_buf_;
   bool nodelay_;
+  shared_ptr<EventLoop> event_loop_;
   int address_;
   int port_;
 
@@ -23,8 +23,28 @@
 
 #include "rpc_response.h"
 
-RpcResponse::RpcResponse(RpcChecker *rpc_checker) : rpc_checker_(rpc_checker) {}
+RpcResponse::RpcResponse(RpcChecker *rpc_checker)
+    : rpc_checker_(rpc_checker), done_(false), stat_(Stat::Count), start_(0),
+      bytes_(0) {}
 
 RpcResponse::~RpcResponse() {}
 
-int RpcResponse::Get() { return this->rpc_checker_->PollResponse(); }
+void RpcResponse::set_done() {
+  if (start_ != 0) {
+    ClientStats::Instance().Record(stat_, start_, bytes_);
+  }
+  done_ = true;
+}
+
+void RpcResponse::Track(Stat stat, unsigned long long bytes) {
+  this->stat_ = stat;
+  this->bytes_ = bytes;
+  this->start_ = ClientStats::Now();
+}
+
+int RpcResponse::Get() {
+  if (done_) {
+    return 0;
+  }
+  return this->rpc_checker_->WaitResponse(this);
+}
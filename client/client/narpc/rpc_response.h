@@ -24,6 +24,9 @@
 #ifndef RPC_RESPONSE_H
 #define RPC_RESPONSE_H
 
+#include <atomic>
+
+#include "common/client_stats.h"
 #include "common/future.h"
 #include "rpc_checker.h"
 #include "rpc_message.h"
@@ -35,8 +38,18 @@ public:
 
   int Get();
 
+  bool is_done() const { return done_; }
+  void set_done();
+
+  // times the request from now until its reply arrives
+  void Track(Stat stat, unsigned long long bytes);
+
 private:
   RpcChecker *rpc_checker_;
+  std::atomic<bool> done_;
+  Stat stat_;
+  unsigned long long start_;
+  unsigned long long bytes_;
 };
 
 #endif /* RPC_RESPONSE_H */
@@ -24,9 +24,11 @@
 #ifndef REFLEX_CHECKER_H
 #define REFLEX_CHECKER_H
 
+class ReflexFuture;
+
 class ReflexChecker {
 public:
-  virtual int PollResponse() = 0;
+  virtual int WaitResponse(ReflexFuture *future) = 0;
 
 private:
 };
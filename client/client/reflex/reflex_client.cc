@@ -27,6 +27,7 @@
 #include <errno.h>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <string>
@@ -36,14 +37,19 @@
 
 #include "common/byte_buffer.h"
 #include "common/crail_constants.h"
+#include "common/pool_allocator.h"
 #include "crail_store.h"
+#include "utils/crail_networking.h"
 
 using namespace std;
 using namespace crail;
 
-ReflexClient::ReflexClient() : isConnected(false), buf_(1024) {
+ReflexClient::ReflexClient(shared_ptr<EventLoop> event_loop)
+    : isConnected(false), send_buf_(1024), recv_buf_(1024),
+      event_loop_(event_loop) {
   this->socket_ = socket(AF_INET, SOCK_STREAM, 0);
-  buf_.set_order(ByteOrder::LittleEndian);
+  send_buf_.set_order(ByteOrder::LittleEndian);
+  recv_buf_.set_order(ByteOrder::LittleEndian);
   this->counter_ = 1;
 }
 
@@ -54,6 +60,11 @@ int ReflexClient::Connect(int address, int port) {
     return 0;
   }
 
+  lock_guard<mutex> guard(send_lock_);
+  if (isConnected) {
+    return 0;
+  }
+
   this->address_ = address;
   this->port_ = port;
 
@@ -70,12 +81,15 @@ int ReflexClient::Connect(int address, int port) {
     perror("cannot connect to server");
     return -1;
   }
+  event_loop_->Register(socket_);
   isConnected = true;
   return 0;
 }
 
 int ReflexClient::Close() {
+  lock_guard<mutex> guard(send_lock_);
   if (isConnected) {
+    event_loop_->Unregister(socket_);
     close(socket_);
     isConnected = false;
   }
@@ -121,41 +135,89 @@ ReflexClient::IssueOperation(int type, long long lba,
     return nullptr;
   }
 
-  unsigned long long ticket = counter_++;
+  while (inflight() >= kMaxInflight) {
+    lock_guard<mutex> guard(recv_lock_);
+    if (inflight() >= kMaxInflight && PollResponse() < 0) {
+      return nullptr;
+    }
+  }
+
+  // register the future before sending, another thread may be reading
+  unsigned long long ticket;
+  shared_ptr<ReflexFuture> future;
+  {
+    lock_guard<mutex> guard(map_lock_);
+    ticket = counter_++;
+    while (ticket == 0 || responseMap.count(ticket) > 0) {
+      ticket = counter_++;
+    }
+    future = MakePooled<ReflexFuture>(this, ticket, payload);
+    future->Track(type == kCmdPut ? Stat::StorageWrite : Stat::StorageRead,
+                  remaining);
+    responseMap.insert({ticket, future});
+  }
   ReflexHeader request(type, ticket, lba, count);
 
+  lock_guard<mutex> guard(send_lock_);
   // create file request
-  buf_.Clear();
-  request.Write(buf_);
-
-  // send header
-  buf_.Flip();
-  if (SendBytes(buf_.get_bytes(), buf_.remaining()) < 0) {
+  send_buf_.Clear();
+  request.Write(send_buf_);
+
+  // send header and payload with a single gather send
+  send_buf_.Flip();
+  struct iovec iov[2];
+  iov[0].iov_base = send_buf_.get_bytes();
+  iov[0].iov_len = send_buf_.remaining();
+  iov[1].iov_base = payload->get_bytes();
+  iov[1].iov_len = type == kCmdPut ? remaining : 0;
+  if (SendVector(socket_, iov, 2) < 0) {
+    lock_guard<mutex> map_guard(map_lock_);
+    responseMap.erase(ticket);
     return nullptr;
   }
-  if (type == kCmdPut) {
-    if (SendBytes(payload->get_bytes(), remaining) < 0) {
-      return nullptr;
+
+  return future;
+}
+
+int ReflexClient::WaitResponse(ReflexFuture *future) {
+  lock_guard<mutex> guard(recv_lock_);
+  while (!future->is_done()) {
+    if (PollResponse() < 0) {
+      return -1;
     }
   }
+  return 0;
+}
 
-  shared_ptr<ReflexFuture> future =
-      make_shared<ReflexFuture>(this, ticket, payload);
-  responseMap.insert({ticket, future});
-  return future;
+int ReflexClient::inflight() const {
+  lock_guard<mutex> guard(map_lock_);
+  return responseMap.size();
 }
 
 int ReflexClient::PollResponse() {
   // recv resp header
-  buf_.Clear();
-  if (RecvBytes(buf_.get_bytes(), header_.Size()) < 0) {
+  recv_buf_.Clear();
+  if (RecvBytes(recv_buf_.get_bytes(), header_.Size()) < 0) {
     return -1;
   }
-  header_.Update(buf_);
+  header_.Update(recv_buf_);
   long long ticket = header_.ticket();
 
-  shared_ptr<ReflexFuture> future = responseMap[ticket];
-  responseMap.erase(ticket);
+  shared_ptr<ReflexFuture> future = nullptr;
+  {
+    lock_guard<mutex> guard(map_lock_);
+    auto iter = responseMap.find(ticket);
+    if (iter != responseMap.end()) {
+      future = iter->second;
+      responseMap.erase(iter);
+    }
+  }
+  if (!future) {
+    // a late reply nobody waits for is skipped, same as in RpcClient
+    int size =
+        header_.type() == kCmdGet ? header_.count() * kReflexBlockSize : 0;
+    return DrainBytes(size);
+  }
 
   if (header_.type() == kCmdGet) {
     shared_ptr<ByteBuffer> payload = future->buffer();
@@ -164,40 +226,26 @@ int ReflexClient::PollResponse() {
       return -1;
     }
   }
+  future->set_done();
 
   return 0;
 }
 
-int ReflexClient::SendBytes(unsigned char *buf, int size) {
-  int res = send(socket_, buf, (size_t)size, (int)0);
-  if (res < 0) {
-    return res;
-  }
-  int remaining = size - res;
-  while (remaining > 0) {
-    int offset = size - remaining;
-    res = send(socket_, buf + offset, (size_t)remaining, (int)0);
-    if (res < 0) {
-      return res;
+int ReflexClient::DrainBytes(int size) {
+  while (size > 0) {
+    int chunk = size < recv_buf_.size() ? size : recv_buf_.size();
+    recv_buf_.Clear();
+    if (RecvBytes(recv_buf_.get_bytes(), chunk) < 0) {
+      return -1;
     }
-    remaining -= res;
+    size -= chunk;
   }
-  return remaining;
+  return 0;
 }
 
 int ReflexClient::RecvBytes(unsigned char *buf, int size) {
-  int res = recv(socket_, buf, (size_t)size, (int)0);
-  if (res < 0) {
-    return res;
-  }
-  int remaining = size - res;
-  while (remaining > 0) {
-    int offset = size - remaining;
-    res = recv(socket_, buf + offset, (size_t)remaining, (int)0);
-    if (res < 0) {
-      return res;
-    }
-    remaining -= res;
-  }
-  return remaining;
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = size;
+  return RecvVector(socket_, &iov, 1, event_loop_.get());
 }
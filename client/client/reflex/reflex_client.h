@@ -26,6 +26,7 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <stdio.h>
@@ -38,6 +39,8 @@
 #include <unordered_map>
 
 #include "common/byte_buffer.h"
+#include "common/event_loop.h"
+#include "common/pool_allocator.h"
 #include "common/serializable.h"
 #include "reflex_checker.h"
 #include "reflex_future.h"
@@ -54,33 +57,46 @@ const short kCmdPut = 1;
 
 class ReflexClient : public ReflexChecker {
 public:
-  ReflexClient();
+  ReflexClient(shared_ptr<EventLoop> event_loop);
   virtual ~ReflexClient();
 
   const int kNarpcHeader = 12;
   const int kRpcHeader = 4;
+  static const int kMaxInflight = 1024;
 
   int Connect(int address, int port);
   shared_ptr<ReflexFuture> Put(long long lba, shared_ptr<ByteBuffer> payload);
   shared_ptr<ReflexFuture> Get(long long lba, shared_ptr<ByteBuffer> payload);
-  int PollResponse();
+  int WaitResponse(ReflexFuture *future);
   int Close();
 
+  int inflight() const;
+
 private:
+  int PollResponse();
   shared_ptr<ReflexFuture> IssueOperation(int type, long long lba,
                                           shared_ptr<ByteBuffer> payload);
-  int SendBytes(unsigned char *buf, int size);
+  int DrainBytes(int size);
   int RecvBytes(unsigned char *buf, int size);
   void Debug(int address, int port);
 
   int socket_;
-  unordered_map<long long, shared_ptr<ReflexFuture>> responseMap;
-  bool isConnected;
-  ByteBuffer buf_;
+  unordered_map<long long, shared_ptr<ReflexFuture>, hash<long long>,
+                equal_to<long long>,
+                PoolAllocator<pair<const long long, shared_ptr<ReflexFuture>>>>
+      responseMap;
+  atomic<bool> isConnected;
+  // same locking scheme as RpcClient
+  mutex send_lock_;
+  mutex recv_lock_;
+  mutable mutex map_lock_;
+  ByteBuffer send_buf_;
+  ByteBuffer recv_buf_;
   ReflexHeader header_;
   atomic<unsigned long long> counter_;
   int port_;
   int address_;
+  shared_ptr<EventLoop> event_loop_;
 };
 } // namespace crail
 
@@ -25,10 +25,29 @@
 
 ReflexFuture::ReflexFuture(ReflexChecker *reflex_checker, long long ticket,
                            shared_ptr<ByteBuffer> buffer)
-    : reflex_checker_(reflex_checker), ticket_(ticket) {
+    : reflex_checker_(reflex_checker), ticket_(ticket), done_(false),
+      stat_(Stat::Count), start_(0), bytes_(0) {
   this->buffer_ = buffer;
 }
 
 ReflexFuture::~ReflexFuture() {}
 
-int ReflexFuture::Get() { return reflex_checker_->PollResponse(); }
+void ReflexFuture::set_done() {
+  if (start_ != 0) {
+    ClientStats::Instance().Record(stat_, start_, bytes_);
+  }
+  done_ = true;
+}
+
+void ReflexFuture::Track(Stat stat, unsigned long long bytes) {
+  this->stat_ = stat;
+  this->bytes_ = bytes;
+  this->start_ = ClientStats::Now();
+}
+
+int ReflexFuture::Get() {
+  if (done_) {
+    return 0;
+  }
+  return reflex_checker_->WaitResponse(this);
+}
@@ -25,8 +25,10 @@
 #define REFLEX_FUTURE_H
 
 #include "common/byte_buffer.h"
+#include "common/client_stats.h"
 #include "common/future.h"
 #include "reflex_checker.h"
+#include <atomic>
 #include <memory>
 
 using namespace std;
@@ -42,13 +44,20 @@ public:
 
   long long ticket() const { return ticket_; }
   bool is_done() const { return done_; }
+  void set_done();
+
+  // times the request from now until its reply arrives
+  void Track(Stat stat, unsigned long long bytes);
   shared_ptr<ByteBuffer> buffer() { return buffer_; }
 
 private:
   ReflexChecker *reflex_checker_;
   shared_ptr<ByteBuffer> buffer_;
   long long ticket_;
-  bool done_;
+  atomic<bool> done_;
+  Stat stat_;
+  unsigned long long start_;
+  unsigned long long bytes_;
 };
 
 #endif /* REFLEX_FUTURE_H */
@@ -23,6 +23,7 @@
 
 #include <iostream>
 
+#include "common/pool_allocator.h"
 #include "narpc_read_request.h"
 #include "narpc_read_response.h"
 #include "narpc_storage_request.h"
@@ -33,8 +34,8 @@
 
 using namespace std;
 
-NarpcStorageClient::NarpcStorageClient()
-    : RpcClient(NarpcStorageClient::kNodelay) {}
+NarpcStorageClient::NarpcStorageClient(shared_ptr<EventLoop> event_loop)
+    : RpcClient(NarpcStorageClient::kNodelay, event_loop) {}
 
 NarpcStorageClient::~NarpcStorageClient() {}
 
@@ -42,7 +43,8 @@ shared_ptr<Future> NarpcStorageClient::WriteData(int key, long long address,
                                                  shared_ptr<ByteBuffer> buf) {
   NarpcWriteRequest write_request(key, address, buf->remaining(), buf);
   shared_ptr<NarpcWriteResponse> write_response =
-      make_shared<NarpcWriteResponse>(this);
+      MakePooled<NarpcWriteResponse>(this);
+  write_response->Track(Stat::StorageWrite, buf->remaining());
   if (IssueRequest(write_request, write_response) < 0) {
     return nullptr;
   }
@@ -53,7 +55,8 @@ shared_ptr<Future> NarpcStorageClient::ReadData(int key, long long address,
                                                 shared_ptr<ByteBuffer> buf) {
   NarpcReadRequest read_request(key, address, buf->remaining());
   shared_ptr<NarpcReadResponse> read_response =
-      make_shared<NarpcReadResponse>(this, buf);
+      MakePooled<NarpcReadResponse>(this, buf);
+  read_response->Track(Stat::StorageRead, buf->remaining());
   if (IssueRequest(read_request, read_response) < 0) {
     return nullptr;
   }
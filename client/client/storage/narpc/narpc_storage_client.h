@@ -29,7 +29,7 @@
 
 class NarpcStorageClient : public RpcClient, public StorageClient {
 public:
-  NarpcStorageClient();
+  NarpcStorageClient(shared_ptr<EventLoop> event_loop);
   virtual ~NarpcStorageClient();
 
   static const bool kNodelay = true;
@@ -38,6 +38,7 @@ public:
     return RpcClient::Connect(address, port);
   }
   int Close() { return RpcClient::Close(); }
+  int inflight() const { return RpcClient::inflight(); }
   shared_ptr<Future> WriteData(int key, long long address,
                                shared_ptr<ByteBuffer> buf);
   shared_ptr<Future> ReadData(int key, long long address,
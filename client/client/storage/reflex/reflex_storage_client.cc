@@ -27,7 +27,8 @@
 
 using namespace std;
 
-ReflexStorageClient::ReflexStorageClient() {}
+ReflexStorageClient::ReflexStorageClient(shared_ptr<EventLoop> event_loop)
+    : ReflexClient(event_loop) {}
 
 ReflexStorageClient::~ReflexStorageClient() {}
 
@@ -29,13 +29,14 @@
 
 class ReflexStorageClient : public ReflexClient, public StorageClient {
 public:
-  ReflexStorageClient();
+  ReflexStorageClient(shared_ptr<EventLoop> event_loop);
   virtual ~ReflexStorageClient();
 
   int Connect(int address, int port) {
     return ReflexClient::Connect(address, port);
   }
   int Close() { return ReflexClient::Close(); }
+  int inflight() const { return ReflexClient::inflight(); }
   shared_ptr<Future> WriteData(int key, long long address,
                                shared_ptr<ByteBuffer> buf);
   shared_ptr<Future> ReadData(int key, long long address,
@@ -30,45 +30,64 @@
 
 using namespace crail;
 
-StorageCache::StorageCache() {}
+StorageCache::StorageCache(shared_ptr<EventLoop> event_loop)
+    : event_loop_(event_loop), pool_size_(kPoolSize) {}
 
 StorageCache::~StorageCache() {}
 
 void StorageCache::Close() {
-  for (std::pair<long long, shared_ptr<StorageClient>> element : cache_) {
-    element.second->Close();
-    // std::cout << element.first << " :: " << element.second << std::endl;
+  for (Shard &shard : shards_) {
+    lock_guard<mutex> guard(shard.lock);
+    for (auto &element : shard.pools) {
+      for (shared_ptr<StorageClient> &client : element.second.clients) {
+        client->Close();
+      }
+    }
   }
 }
 
-int StorageCache::Put(long long position, shared_ptr<StorageClient> client) {
-  long long key = ComputeKey(position);
-  cache_.insert({key, client});
-  return 0;
+shared_ptr<StorageClient> StorageCache::Get(long long key, int storage_class) {
+  Shard &shard = GetShard(key);
+  lock_guard<mutex> guard(shard.lock);
+  return Select(shard.pools[key], storage_class);
 }
 
-shared_ptr<StorageClient> StorageCache::Get(long long position,
-                                            int storage_class) {
-  long long key = ComputeKey(position);
-  auto iter = cache_.find(key);
-  if (iter != cache_.end()) {
-    return iter->second;
-  } else {
-    shared_ptr<StorageClient> client = CreateClient(storage_class);
-    Put(key, client);
-    return client;
+shared_ptr<StorageClient> StorageCache::Select(Pool &pool, int storage_class) {
+  // least outstanding requests wins, ties are broken round-robin so that
+  // consecutive blocks of a stream are striped over the pool
+  int count = pool.clients.size();
+  unsigned int start = pool.next++;
+  shared_ptr<StorageClient> best = nullptr;
+  int best_inflight = 0;
+  for (int i = 0; i < count; i++) {
+    shared_ptr<StorageClient> &client = pool.clients[(start + i) % count];
+    int inflight = client->inflight();
+    if (!best || inflight < best_inflight) {
+      best = client;
+      best_inflight = inflight;
+    }
+    if (best_inflight == 0) {
+      break;
+    }
+  }
+
+  if (!best || (best_inflight > 0 && count < pool_size_)) {
+    best = CreateClient(storage_class);
+    pool.clients.push_back(best);
   }
+  return best;
+}
+
+StorageCache::Shard &StorageCache::GetShard(long long key) {
+  // keys are ip:port pairs, mix them before picking a shard
+  unsigned long long hash = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+  return shards_[(hash >> 32) % kCacheShards];
 }
 
 shared_ptr<StorageClient> StorageCache::CreateClient(int storage_class) {
   if (storage_class == 0) {
-    return make_shared<NarpcStorageClient>();
+    return make_shared<NarpcStorageClient>(event_loop_);
   } else {
-    return make_shared<ReflexStorageClient>();
+    return make_shared<ReflexStorageClient>(event_loop_);
   }
 }
-
-long long StorageCache::ComputeKey(long long position) {
-  long long count = position / kBlockSize;
-  return count * kBlockSize;
-}
@@ -24,27 +24,48 @@
 #ifndef STORAGE_CACHE_H
 #define STORAGE_CACHE_H
 
-#include "storage_client.h"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
+
+#include "common/crail_constants.h"
+#include "common/event_loop.h"
+#include "storage_client.h"
 
 using namespace std;
 using namespace crail;
 
 class StorageCache {
 public:
-  StorageCache();
+  StorageCache(shared_ptr<EventLoop> event_loop);
   virtual ~StorageCache();
 
   shared_ptr<StorageClient> Get(long long key, int storage_class);
   void Close();
 
+  void set_pool_size(int pool_size) { this->pool_size_ = pool_size; }
+  int pool_size() const { return pool_size_; }
+
 private:
-  int Put(long long key, shared_ptr<StorageClient> endpoint);
+  // connections to one datanode, grown up to pool_size_ on demand
+  struct Pool {
+    vector<shared_ptr<StorageClient>> clients;
+    unsigned int next = 0;
+  };
+  struct Shard {
+    mutex lock;
+    unordered_map<long long, Pool> pools;
+  };
+
   shared_ptr<StorageClient> CreateClient(int storage_class);
-  long long ComputeKey(long long position);
+  shared_ptr<StorageClient> Select(Pool &pool, int storage_class);
+  Shard &GetShard(long long key);
 
-  unordered_map<long long, shared_ptr<StorageClient>> cache_;
+  Shard shards_[kCacheShards];
+  shared_ptr<EventLoop> event_loop_;
+  atomic<int> pool_size_;
 };
 
 #endif /* STORAGE_CACHE_H */
@@ -39,6 +39,7 @@ public:
                                        shared_ptr<ByteBuffer> buf) = 0;
   virtual shared_ptr<Future> ReadData(int key, long long address,
                                       shared_ptr<ByteBuffer> buf) = 0;
+  virtual int inflight() const = 0;
 };
 
 #endif /* STORAGE_CLIENT_H */
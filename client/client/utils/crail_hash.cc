@@ -23,21 +23,34 @@
 
 #include "crail_hash.h"
 
-int file_hash(string name) {
-  const char *str = name.c_str();
-  int length = name.length();
-  int hash_code = 0;
-  for (uint32_t i = 0; i < length; i++) {
-    hash_code = 31 * hash_code + str[i];
+int file_hash(const char *name, int length) {
+  // four characters per step keep the multiplies independent, unsigned
+  // arithmetic wraps exactly like the Java int version
+  unsigned int hash_code = 0;
+  int i = 0;
+  for (; i + 4 <= length; i += 4) {
+    hash_code = 923521u * hash_code + 29791u * (int)name[i] +
+                961u * (int)name[i + 1] + 31u * (int)name[i + 2] +
+                (int)name[i + 3];
   }
-  return hash_code;
+  for (; i < length; i++) {
+    hash_code = 31u * hash_code + (int)name[i];
+  }
+  return (int)hash_code;
 }
 
-int file_hash(string &name, int &start) {
-  int hash_code = 0;
-  while (start < name.length() && name.at(start) != '/') {
-    hash_code = 31 * hash_code + name.at(start);
-    start++;
+int file_hash(const string &name) {
+  return file_hash(name.data(), name.length());
+}
+
+int file_hash(const string &name, int &start) {
+  const char *str = name.data();
+  int length = name.length();
+  int end = start;
+  while (end < length && str[end] != '/') {
+    end++;
   }
+  int hash_code = file_hash(str + start, end - start);
+  start = end;
   return hash_code;
 }
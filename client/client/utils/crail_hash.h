@@ -30,7 +30,10 @@
 
 using namespace std;
 
-int file_hash(string name);
-int file_hash(string &name, int &start);
+// Java String.hashCode of a name component
+int file_hash(const char *name, int length);
+int file_hash(const string &name);
+// hashes from start up to the next '/', start is left on the '/'
+int file_hash(const string &name, int &start);
 
 #endif /* CRAIL_HASH_H */
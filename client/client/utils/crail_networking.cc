@@ -23,7 +23,13 @@
 
 #include "crail_networking.h"
 
+#include <errno.h>
 #include <sstream>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "common/event_loop.h"
+#include "common/io_ring.h"
 
 string GetAddress(int address, int port) {
   int tmp = address;
@@ -40,3 +46,81 @@ string GetAddress(int address, int port) {
 
   return addressport.str();
 }
+
+static void AdvanceVector(struct iovec *&iov, int &count, size_t bytes) {
+  while (count > 0 && bytes >= iov->iov_len) {
+    bytes -= iov->iov_len;
+    iov++;
+    count--;
+  }
+  if (count > 0) {
+    iov->iov_base = (unsigned char *)iov->iov_base + bytes;
+    iov->iov_len -= bytes;
+  }
+}
+
+int SendVector(int socket, struct iovec *iov, int count) {
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  AdvanceVector(iov, count, 0);
+  while (count > 0) {
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    ssize_t res = sendmsg(socket, &msg, MSG_NOSIGNAL);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    AdvanceVector(iov, count, res);
+  }
+  return 0;
+}
+
+int RecvVector(int socket, struct iovec *iov, int count,
+               EventLoop *event_loop) {
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  AdvanceVector(iov, count, 0);
+  while (count > 0) {
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    IoRing *ring = nullptr;
+    if (event_loop && event_loop->io_ring()) {
+      ring = IoRing::ThreadRing();
+    }
+    ssize_t res;
+    if (ring) {
+      // the kernel receives inline or waits for the data, one syscall
+      // either way
+      res = ring->RecvMsg(socket, &msg, 0);
+    } else {
+      res = recvmsg(socket, &msg, MSG_DONTWAIT);
+    }
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (ring) {
+        // a ring that turned out unusable falls back to epoll
+        if (!IoRing::ThreadRing()) {
+          continue;
+        }
+        return -1;
+      }
+      if (errno != EAGAIN) {
+        return -1;
+      }
+      if (event_loop && event_loop->WaitReadable(socket) < 0) {
+        return -1;
+      }
+      continue;
+    }
+    if (res == 0) {
+      return -1;
+    }
+    AdvanceVector(iov, count, res);
+  }
+  return 0;
+}
@@ -25,9 +25,20 @@
 #define CRAIL_NETWORKING_H
 
 #include <string>
+#include <sys/uio.h>
 
 using namespace std;
 
+class EventLoop;
+
 string GetAddress(int address, int port);
 
+// gather/scatter the iovec array over a socket with as few syscalls as
+// possible, the array is modified in place on short transfers. Receives
+// wait on the event loop whenever the socket runs dry, or in the thread's
+// io_uring if the event loop asks for it.
+int SendVector(int socket, struct iovec *iov, int count);
+int RecvVector(int socket, struct iovec *iov, int count,
+               EventLoop *event_loop);
+
 #endif /* CRAIL_NETWORKING_H */
@@ -0,0 +1,104 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "histogram.h"
+
+Histogram::Histogram() { Reset(); }
+
+Histogram::~Histogram() {}
+
+void Histogram::Record(unsigned long long value) {
+  buckets_[Bucket(value)].fetch_add(1, memory_order_relaxed);
+  count_.fetch_add(1, memory_order_relaxed);
+  sum_.fetch_add(value, memory_order_relaxed);
+  unsigned long long max = max_.load(memory_order_relaxed);
+  while (value > max &&
+         !max_.compare_exchange_weak(max, value, memory_order_relaxed)) {
+  }
+}
+
+void Histogram::Reset() {
+  for (atomic<unsigned long long> &bucket : buckets_) {
+    bucket.store(0, memory_order_relaxed);
+  }
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+void Histogram::Merge(const Histogram &other) {
+  for (int i = 0; i < kHistogramBuckets; i++) {
+    buckets_[i].fetch_add(other.buckets_[i].load(memory_order_relaxed),
+                          memory_order_relaxed);
+  }
+  count_.fetch_add(other.count_.load(), memory_order_relaxed);
+  sum_.fetch_add(other.sum_.load(), memory_order_relaxed);
+  unsigned long long value = other.max_.load();
+  unsigned long long max = max_.load(memory_order_relaxed);
+  while (value > max &&
+         !max_.compare_exchange_weak(max, value, memory_order_relaxed)) {
+  }
+}
+
+unsigned long long Histogram::Percentile(double fraction) const {
+  unsigned long long count = count_;
+  if (count == 0) {
+    return 0;
+  }
+
+  unsigned long long rank = fraction * count;
+  if (rank >= count) {
+    rank = count - 1;
+  }
+  unsigned long long seen = 0;
+  for (int i = 0; i < kHistogramBuckets; i++) {
+    seen += buckets_[i].load(memory_order_relaxed);
+    if (seen > rank) {
+      unsigned long long limit = BucketLimit(i);
+      return limit < max_ ? limit : max_.load();
+    }
+  }
+  return max_;
+}
+
+int Histogram::Bucket(unsigned long long value) {
+  if (value < (1ULL << kHistogramPrecision)) {
+    return value;
+  }
+  int msb = 63 - __builtin_clzll(value);
+  int shift = msb - kHistogramPrecision;
+  int sub = (value >> shift) & ((1 << kHistogramPrecision) - 1);
+  return ((shift + 1) << kHistogramPrecision) + sub;
+}
+
+unsigned long long Histogram::BucketLimit(int bucket) {
+  int group = bucket >> kHistogramPrecision;
+  unsigned long long sub = bucket & ((1 << kHistogramPrecision) - 1);
+  if (group == 0) {
+    return sub;
+  }
+  int shift = group - 1;
+  unsigned long long base = (1ULL << kHistogramPrecision) + sub;
+  // largest value that falls into the bucket
+  return (base << shift) + ((1ULL << shift) - 1);
+}
@@ -0,0 +1,65 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <atomic>
+
+using namespace std;
+
+// values below 2^kHistogramPrecision are counted exactly, larger ones in
+// 2^kHistogramPrecision buckets per power of two (about 6% wide)
+const int kHistogramPrecision = 4;
+const int kHistogramBuckets = (64 - kHistogramPrecision + 1)
+                              << kHistogramPrecision;
+
+// Lock-free HDR-style histogram, recording from many threads at once only
+// costs a few relaxed atomic increments.
+class Histogram {
+public:
+  Histogram();
+  virtual ~Histogram();
+
+  void Record(unsigned long long value);
+  void Reset();
+  // adds all samples of other, e.g. to combine per-thread histograms
+  void Merge(const Histogram &other);
+
+  // smallest value that at least the given fraction of samples is below
+  unsigned long long Percentile(double fraction) const;
+  unsigned long long count() const { return count_; }
+  unsigned long long sum() const { return sum_; }
+  unsigned long long max() const { return max_; }
+
+private:
+  static int Bucket(unsigned long long value);
+  static unsigned long long BucketLimit(int bucket);
+
+  atomic<unsigned long long> buckets_[kHistogramBuckets];
+  atomic<unsigned long long> count_;
+  atomic<unsigned long long> sum_;
+  atomic<unsigned long long> max_;
+};
+
+#endif /* HISTOGRAM_H */
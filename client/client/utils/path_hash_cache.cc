@@ -0,0 +1,63 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "path_hash_cache.h"
+
+#include <string.h>
+
+#include "utils/crail_hash.h"
+
+PathHashCache &PathHashCache::ThreadCache() {
+  // zero initialized, an entry with prefix_length 0 never matches as the
+  // root has no components to cache
+  static thread_local PathHashCache cache;
+  return cache;
+}
+
+int PathHashCache::Hash(const string &name, int prefix_length,
+                        int components[]) {
+  const char *data = name.data();
+  for (Entry &entry : entries_) {
+    if (entry.prefix_length == prefix_length &&
+        memcmp(entry.prefix, data, prefix_length) == 0) {
+      memcpy(components, entry.components, entry.length * sizeof(int));
+      return entry.length;
+    }
+  }
+
+  int length = 0;
+  for (int index = 1; index <= prefix_length && length < kDirectoryDepth - 1;
+       index++) {
+    components[length++] = file_hash(name, index);
+  }
+
+  if (prefix_length > 0 && prefix_length <= kPathHashPrefix) {
+    Entry &entry = entries_[next_];
+    next_ = (next_ + 1) % kPathHashEntries;
+    entry.prefix_length = prefix_length;
+    entry.length = length;
+    memcpy(entry.components, components, length * sizeof(int));
+    memcpy(entry.prefix, data, prefix_length);
+  }
+  return length;
+}
@@ -0,0 +1,62 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_HASH_CACHE_H
+#define PATH_HASH_CACHE_H
+
+#include <string>
+
+#include "common/crail_constants.h"
+
+using namespace std;
+using namespace crail;
+
+// longest parent directory path the cache keeps
+const int kPathHashPrefix = 128;
+
+// Remembers the component hashes of the last few parent directories a thread
+// resolved, keys under a common /job/stage prefix then only hash their last
+// component. Plain data, so the per-thread instance needs no guarded
+// initialization.
+class PathHashCache {
+public:
+  static PathHashCache &ThreadCache();
+
+  // hashes of the components of name[0, prefix_length), where name[0] and
+  // name[prefix_length] are '/'. Returns their number, at most
+  // kDirectoryDepth - 1 so the last component of name still fits.
+  int Hash(const string &name, int prefix_length, int components[]);
+
+private:
+  struct Entry {
+    int prefix_length;
+    int length;
+    int components[kDirectoryDepth];
+    char prefix[kPathHashPrefix];
+  };
+
+  Entry entries_[kPathHashEntries];
+  int next_;
+};
+
+#endif /* PATH_HASH_CACHE_H */
@@ -21,20 +21,46 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <string>
 #include <unistd.h>
 #include <vector>
 
 #include "iobench.h"
+#include "load_benchmark.h"
+#include "standin/standin_cluster.h"
 
+#include "common/buffer_pool.h"
+#include "common/client_stats.h"
 #include "crail_file.h"
 #include "utils/micro_clock.h"
 
 using namespace std;
 
+// DRAM of the in-process datanode stand-in, only touched pages are backed
+static const long long kStandinMemory = 2048LL * 1024 * 1024;
+
+// count heap allocations of the whole process, including the client library
+static atomic<unsigned long long> allocations(0);
+
+void *operator new(size_t size) {
+  allocations++;
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
 enum class Operation {
   Undefined = 0,
   GetFile = 1,
@@ -46,6 +72,7 @@ enum class Operation {
   GetKey = 7,
   PutBenchmark = 8,
   GetBenchmark = 9,
+  LoadBenchmark = 10,
 };
 
 struct Settings {
@@ -57,6 +84,14 @@ struct Settings {
   int size;
   string dstfile;
   bool enumerable;
+  int lookup_ttl;
+  bool io_ring;
+  int threads;
+  int stores;
+  string mix;
+  double rate;
+  int preload;
+  bool standin;
 };
 
 Operation getOperation(string name) {
@@ -78,6 +113,8 @@ Operation getOperation(string name) {
     return Operation::PutBenchmark;
   } else if (name == "GetBenchmark") {
     return Operation::GetBenchmark;
+  } else if (name == "LoadBenchmark") {
+    return Operation::LoadBenchmark;
   } else {
     return Operation::Undefined;
   }
@@ -88,7 +125,12 @@ void printSettings(Settings &settings) {
        << ", operation " << static_cast<int>(settings.operation)
        << ", filename " << settings.filename << ", loop " << settings.loop
        << ", size " << settings.size << ", dstfile " << settings.dstfile
-       << ", enumerable " << settings.enumerable << endl;
+       << ", enumerable " << settings.enumerable << ", lookup_ttl "
+       << settings.lookup_ttl << ", io_ring " << settings.io_ring
+       << ", threads " << settings.threads << ", stores " << settings.stores
+       << ", mix " << settings.mix << ", rate " << settings.rate
+       << ", preload " << settings.preload << ", standin " << settings.standin
+       << endl;
 }
 
 void setDefaults(Settings &settings) {
@@ -100,6 +142,36 @@ void setDefaults(Settings &settings) {
   settings.size = 1024;
   settings.dstfile = "/dst";
   settings.enumerable = false;
+  settings.lookup_ttl = 0;
+  settings.io_ring = false;
+  settings.threads = 1;
+  settings.stores = 0;
+  settings.mix = "put:50,get:50";
+  settings.rate = 0;
+  settings.preload = 0;
+  settings.standin = false;
+}
+
+int runLoadBenchmark(Settings &settings) {
+  LoadSettings load;
+  load.address = settings.address;
+  load.port = settings.port;
+  load.threads = settings.threads;
+  load.stores = settings.stores;
+  load.ops = settings.loop;
+  load.preload = settings.preload;
+  load.size = settings.size;
+  load.rate = settings.rate;
+  load.prefix = settings.filename;
+  load.enumerable = settings.enumerable;
+  load.lookup_ttl = settings.lookup_ttl;
+  load.io_ring = settings.io_ring;
+  if (LoadBenchmark::ParseMix(settings.mix, load) < 0) {
+    return -1;
+  }
+
+  LoadBenchmark benchmark(load);
+  return benchmark.Run();
 }
 
 Iobench::Iobench(string address, int port) { crail_.Initialize(address, port); }
@@ -140,7 +212,7 @@ int Iobench::WriteFile(string local_file, string dst_file, bool enumerable) {
   CrailFile *file = static_cast<CrailFile *>(node);
   unique_ptr<CrailOutputstream> outputstream = file->outputstream();
 
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(kBufferSize);
+  shared_ptr<ByteBuffer> buf = BufferPool::Instance().Get(kBufferSize);
   while (size_t len = fread(buf->get_bytes(), 1, buf->remaining(), fp)) {
     buf->set_position(buf->position() + len);
     if (buf->remaining() > 0) {
@@ -192,7 +264,7 @@ int Iobench::ReadFile(string src_file, string local_file) {
   CrailFile *file = static_cast<CrailFile *>(node);
   unique_ptr<CrailInputstream> inputstream = file->inputstream();
 
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(kBufferSize);
+  shared_ptr<ByteBuffer> buf = BufferPool::Instance().Get(kBufferSize);
   while (inputstream->Read(buf) > 0) {
     buf->Flip();
     while (buf->remaining()) {
@@ -325,9 +397,8 @@ int Iobench::PutKey(const char data[], int len, string dst_file,
   CrailFile *file = static_cast<CrailFile *>(node);
   unique_ptr<CrailOutputstream> outputstream = file->outputstream();
 
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(len);
-  buf->PutBytes(data, len);
-  buf->Flip();
+  shared_ptr<ByteBuffer> buf =
+      make_shared<ByteBuffer>((unsigned char *)data, len);
   while (buf->remaining() > 0) {
     if (outputstream->Write(buf) < 0) {
       return -1;
@@ -353,26 +424,45 @@ int Iobench::GetKey(char data[], int len, string src_file) {
   CrailFile *file = static_cast<CrailFile *>(node);
   unique_ptr<CrailInputstream> inputstream = file->inputstream();
 
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(len);
-  while (buf->remaining()) {
-    if (inputstream->Read(buf) < 0) {
-      return -1;
-    }
+  shared_ptr<ByteBuffer> buf =
+      make_shared<ByteBuffer>((unsigned char *)data, len);
+  shared_ptr<Future> read = inputstream->ReadAsync(buf);
+  if (!read || read->Get() < 0) {
+    return -1;
+  }
+  if (buf->remaining() > 0) {
+    // the file is shorter than the buffer
+    return -1;
   }
-  buf->Clear();
-  memcpy(data, buf->get_bytes(), len);
 
   inputstream->Close();
 
   return 0;
 }
 
+int Iobench::LookupKey(string &src_file) {
+  unique_ptr<CrailNode> crail_node = crail_.Lookup(src_file);
+  if (!crail_node) {
+    cout << "lookup node failed" << endl;
+    return -1;
+  }
+  return 0;
+}
+
+int Iobench::DeleteKey(string &src_file) {
+  if (crail_.Remove(src_file, false) < 0) {
+    cout << "remove node failed" << endl;
+    return -1;
+  }
+  return 0;
+}
+
 int main(int argc, char *argv[]) {
   Settings settings;
   setDefaults(settings);
 
   int opt = 0;
-  while ((opt = getopt(argc, argv, "t:f:k:s:a:p:d:e")) != -1) {
+  while ((opt = getopt(argc, argv, "t:f:k:s:a:p:d:el:un:c:m:r:w:x")) != -1) {
     switch (opt) {
     case 't':
       settings.operation = getOperation(optarg);
@@ -397,12 +487,56 @@ int main(int argc, char *argv[]) {
     case 'e':
       settings.enumerable = true;
       break;
+    case 'l':
+      settings.lookup_ttl = atoi(optarg);
+      break;
+    case 'u':
+      settings.io_ring = true;
+      break;
+    case 'n':
+      settings.threads = atoi(optarg);
+      break;
+    case 'c':
+      settings.stores = atoi(optarg);
+      break;
+    case 'm':
+      settings.mix = optarg;
+      break;
+    case 'r':
+      settings.rate = atof(optarg);
+      break;
+    case 'w':
+      settings.preload = atoi(optarg);
+      break;
+    case 'x':
+      settings.standin = true;
+      break;
     }
   }
 
+  // with -x the benchmark runs against a namenode and datanode stand-in in
+  // this process, no cluster needed
+  StandinCluster standin;
+  if (settings.standin) {
+    vector<int> datanode_ports(1, 0);
+    vector<int> reflex_ports;
+    settings.address = "127.0.0.1";
+    if (standin.Start(settings.address, 0, datanode_ports, reflex_ports,
+                      kStandinMemory) < 0) {
+      return 1;
+    }
+    settings.port = standin.namenode_port();
+  }
+
   printSettings(settings);
 
+  if (settings.operation == Operation::LoadBenchmark) {
+    return runLoadBenchmark(settings) < 0 ? 1 : 0;
+  }
+
   Iobench iobench(settings.address, settings.port);
+  iobench.set_lookup_ttl(settings.lookup_ttl);
+  iobench.set_io_ring(settings.io_ring);
 
   int res = -1;
   if (settings.operation == Operation::GetFile) {
@@ -432,8 +566,9 @@ int main(int argc, char *argv[]) {
 
     char data[settings.size];
     MicroClock clock;
+    unsigned long long allocations_start = allocations;
     clock.Start();
-    for (string n : names) {
+    for (string &n : names) {
       if (settings.operation == Operation::PutBenchmark) {
         res = iobench.PutKey(data, settings.size, n, settings.enumerable);
       } else if (settings.operation == Operation::GetBenchmark) {
@@ -448,9 +583,13 @@ int main(int argc, char *argv[]) {
       }
     }
     clock.Stop();
+    unsigned long long _allocations = allocations - allocations_start;
 
     double _latency = clock.Duration() / settings.loop;
     cout << "Latency " << _latency << "[us/op]" << endl;
+    cout << "Allocations " << double(_allocations) / settings.loop
+         << "[allocs/op]" << endl;
+    cout << ClientStats::Instance().Dump();
   }
   return res;
 }
@@ -42,6 +42,11 @@ public:
   int Read(string src_file, int len, int loop);
   int PutKey(const char data[], int len, string dst_file, bool enumerable);
   int GetKey(char data[], int len, string src_file);
+  int LookupKey(string &src_file);
+  int DeleteKey(string &src_file);
+
+  void set_lookup_ttl(int ttl) { crail_.set_lookup_ttl(ttl); }
+  void set_io_ring(bool io_ring) { crail_.set_io_ring(io_ring); }
 
 private:
   CrailStore crail_;
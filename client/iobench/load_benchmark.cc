@@ -0,0 +1,230 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "load_benchmark.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "common/client_stats.h"
+
+static const char *kLoadOpNames[] = {"put", "get", "lookup", "delete"};
+
+LoadBenchmark::LoadBenchmark(LoadSettings &settings)
+    : settings_(settings), keys_(settings.threads),
+      next_key_(settings.threads, 0),
+      latencies_(new Histogram[settings.threads * kLoadOps]),
+      errors_(settings.threads * kLoadOps, 0) {
+  int stores = settings_.stores;
+  if (stores <= 0 || stores > settings_.threads) {
+    stores = settings_.threads;
+  }
+  for (int i = 0; i < stores; i++) {
+    unique_ptr<Iobench> bench(
+        new Iobench(settings_.address, settings_.port));
+    bench->set_lookup_ttl(settings_.lookup_ttl);
+    bench->set_io_ring(settings_.io_ring);
+    benches_.push_back(move(bench));
+  }
+}
+
+LoadBenchmark::~LoadBenchmark() {}
+
+int LoadBenchmark::ParseMix(string mix, LoadSettings &settings) {
+  for (int i = 0; i < kLoadOps; i++) {
+    settings.mix[i] = 0;
+  }
+
+  stringstream stream(mix);
+  string entry;
+  int total = 0;
+  while (getline(stream, entry, ',')) {
+    size_t colon = entry.find(':');
+    string name = entry.substr(0, colon);
+    int weight = colon == string::npos ? 1 : atoi(entry.c_str() + colon + 1);
+    int op = 0;
+    while (op < kLoadOps && name != kLoadOpNames[op]) {
+      op++;
+    }
+    if (op == kLoadOps || weight < 0) {
+      cout << "invalid operation mix " << entry << endl;
+      return -1;
+    }
+    settings.mix[op] = weight;
+    total += weight;
+  }
+  if (total == 0) {
+    cout << "operation mix is empty" << endl;
+    return -1;
+  }
+  return 0;
+}
+
+int LoadBenchmark::Run() {
+  vector<thread> threads;
+  for (int i = 0; i < settings_.threads; i++) {
+    threads.push_back(thread(&LoadBenchmark::Preload, this, i));
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  threads.clear();
+
+  unsigned long long start = ClientStats::Now();
+  for (int i = 0; i < settings_.threads; i++) {
+    threads.push_back(thread(&LoadBenchmark::Work, this, i));
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  double seconds = (ClientStats::Now() - start) / 1e9;
+
+  Report(seconds);
+  return 0;
+}
+
+void LoadBenchmark::Preload(int id) {
+  Iobench &bench = *benches_[id % benches_.size()];
+  vector<char> data(settings_.size);
+  for (int i = 0; i < settings_.preload; i++) {
+    string key = settings_.prefix + to_string(id) + "_" +
+                 to_string(next_key_[id]++);
+    if (bench.PutKey(data.data(), settings_.size, key,
+                     settings_.enumerable) == 0) {
+      keys_[id].push_back(key);
+    }
+  }
+}
+
+void LoadBenchmark::Work(int id) {
+  Iobench &bench = *benches_[id % benches_.size()];
+  vector<string> &keys = keys_[id];
+  Histogram *latencies = &latencies_[id * kLoadOps];
+  unsigned long long *errors = &errors_[id * kLoadOps];
+  vector<char> data(settings_.size);
+
+  mt19937 rng(id + 1);
+  discrete_distribution<int> pick(settings_.mix, settings_.mix + kLoadOps);
+  exponential_distribution<double> gap(settings_.rate > 0 ? settings_.rate
+                                                          : 1);
+  unsigned long long arrival = ClientStats::Now();
+
+  for (int i = 0; i < settings_.ops; i++) {
+    LoadOp op = Pick(id, pick, rng);
+
+    // open-loop latencies count from the scheduled arrival, so time spent
+    // queued behind a slow operation is not hidden
+    unsigned long long start = ClientStats::Now();
+    if (settings_.rate > 0) {
+      arrival += gap(rng) * 1e9;
+      if (arrival > start) {
+        this_thread::sleep_for(chrono::nanoseconds(arrival - start));
+      }
+      start = arrival;
+    }
+
+    int res = -1;
+    int index = keys.empty() ? 0 : rng() % keys.size();
+    if (op == LoadOp::Put) {
+      string key = settings_.prefix + to_string(id) + "_" +
+                   to_string(next_key_[id]++);
+      res = bench.PutKey(data.data(), settings_.size, key,
+                         settings_.enumerable);
+      if (res == 0) {
+        keys.push_back(key);
+      }
+    } else if (op == LoadOp::Get) {
+      res = bench.GetKey(data.data(), settings_.size, keys[index]);
+    } else if (op == LoadOp::Lookup) {
+      res = bench.LookupKey(keys[index]);
+    } else if (op == LoadOp::Delete) {
+      res = bench.DeleteKey(keys[index]);
+      if (res == 0) {
+        keys[index] = keys.back();
+        keys.pop_back();
+      }
+    }
+
+    if (res < 0) {
+      errors[static_cast<int>(op)]++;
+    } else {
+      latencies[static_cast<int>(op)].Record(ClientStats::Now() - start);
+    }
+  }
+}
+
+LoadOp LoadBenchmark::Pick(int id, discrete_distribution<int> &pick,
+                           mt19937 &rng) {
+  LoadOp op = static_cast<LoadOp>(pick(rng));
+  // reads and deletes need a key to work on
+  if (op != LoadOp::Put && keys_[id].empty()) {
+    return LoadOp::Put;
+  }
+  return op;
+}
+
+void LoadBenchmark::Report(double seconds) {
+  unsigned long long total_ops = 0;
+  stringstream out;
+  out << fixed << setprecision(1);
+  out << left << setw(10) << "op" << right << setw(10) << "count"
+      << setw(8) << "errors" << setw(12) << "ops/s" << setw(10) << "mean[us]"
+      << setw(10) << "p50[us]" << setw(10) << "p99[us]" << setw(10)
+      << "p999[us]" << setw(10) << "max[us]" << endl;
+  Histogram all;
+  for (int op = 0; op < kLoadOps; op++) {
+    Histogram merged;
+    unsigned long long errors = 0;
+    for (int i = 0; i < settings_.threads; i++) {
+      merged.Merge(latencies_[i * kLoadOps + op]);
+      errors += errors_[i * kLoadOps + op];
+    }
+    all.Merge(merged);
+    if (merged.count() == 0 && errors == 0) {
+      continue;
+    }
+    total_ops += merged.count();
+    double mean = merged.count() ? double(merged.sum()) / merged.count() : 0;
+    out << left << setw(10) << kLoadOpNames[op] << right << setw(10)
+        << merged.count() << setw(8) << errors << setw(12)
+        << merged.count() / seconds << setw(10) << mean / 1000 << setw(10)
+        << merged.Percentile(0.5) / 1000.0 << setw(10)
+        << merged.Percentile(0.99) / 1000.0 << setw(10)
+        << merged.Percentile(0.999) / 1000.0 << setw(10)
+        << merged.max() / 1000.0 << endl;
+  }
+  double mean = all.count() ? double(all.sum()) / all.count() : 0;
+  out << left << setw(10) << "total" << right << setw(10) << total_ops
+      << setw(8) << "" << setw(12) << total_ops / seconds << setw(10)
+      << mean / 1000 << setw(10) << all.Percentile(0.5) / 1000.0 << setw(10)
+      << all.Percentile(0.99) / 1000.0 << setw(10)
+      << all.Percentile(0.999) / 1000.0 << setw(10) << all.max() / 1000.0
+      << endl;
+
+  cout << "Threads " << settings_.threads << ", stores " << benches_.size()
+       << ", time " << seconds << "[s]" << endl;
+  cout << out.str();
+}
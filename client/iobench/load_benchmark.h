@@ -0,0 +1,95 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOAD_BENCHMARK_H
+#define LOAD_BENCHMARK_H
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "iobench.h"
+#include "utils/histogram.h"
+
+using namespace std;
+
+enum class LoadOp {
+  Put = 0,
+  Get,
+  Lookup,
+  Delete,
+  Count,
+};
+
+const int kLoadOps = static_cast<int>(LoadOp::Count);
+
+struct LoadSettings {
+  string address;
+  int port;
+  int threads;
+  // threads are spread round-robin over this many stores, 0 gives every
+  // thread its own
+  int stores;
+  // operations per thread, after preload keys have been put by every thread
+  int ops;
+  int preload;
+  int size;
+  // arrivals per second and thread, 0 runs closed-loop
+  double rate;
+  // relative weight of every LoadOp
+  int mix[kLoadOps];
+  string prefix;
+  bool enumerable;
+  int lookup_ttl;
+  bool io_ring;
+};
+
+// Drives a random mix of key operations from many threads and reports
+// throughput and latency percentiles per operation.
+class LoadBenchmark {
+public:
+  LoadBenchmark(LoadSettings &settings);
+  virtual ~LoadBenchmark();
+
+  // parses "put:50,get:40,lookup:5,delete:5" into settings.mix
+  static int ParseMix(string mix, LoadSettings &settings);
+
+  int Run();
+
+private:
+  void Preload(int id);
+  void Work(int id);
+  LoadOp Pick(int id, discrete_distribution<int> &pick, mt19937 &rng);
+  void Report(double seconds);
+
+  LoadSettings settings_;
+  vector<unique_ptr<Iobench>> benches_;
+  // per thread state, indexed by thread id
+  vector<vector<string>> keys_;
+  vector<int> next_key_;
+  unique_ptr<Histogram[]> latencies_;
+  vector<unsigned long long> errors_;
+};
+
+#endif /* LOAD_BENCHMARK_H */
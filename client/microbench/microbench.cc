@@ -0,0 +1,265 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "common/byte_buffer.h"
+#include "directory_record.h"
+#include "metadata/block_info.h"
+#include "metadata/datanode_info.h"
+#include "metadata/file_info.h"
+#include "metadata/filename.h"
+#include "namenode/create_request.h"
+#include "namenode/lookup_response.h"
+#include "utils/crail_hash.h"
+
+using namespace std;
+using namespace crail;
+
+// Per-request encode and decode work of the client. Every benchmark works on
+// fixed inputs so runs are comparable across encoding changes.
+
+// small enough to stay in L1, so loops measure encoding and not memory
+static const int kScratchSize = 4096;
+static string kName = "/job-0042/intermediate/shuffle-0017-0003";
+
+static void WriteDatanodeInfo(ByteBuffer &buf) {
+  int address = 0x0100007f;
+  buf.PutInt(0);
+  buf.PutInt(0);
+  buf.PutInt(0);
+  buf.PutBytes((char *)&address, 4);
+  buf.PutInt(50020);
+}
+
+static void WriteBlockInfo(ByteBuffer &buf) {
+  WriteDatanodeInfo(buf);
+  buf.PutLong(7340032 / 512);
+  buf.PutLong(7340032);
+  buf.PutInt(kBlockSize);
+  buf.PutInt(0);
+}
+
+static void WriteFileInfo(ByteBuffer &buf) {
+  buf.PutLong(123456);
+  buf.PutLong(1048576);
+  buf.PutInt(0);
+  buf.PutLong(8192);
+  buf.PutLong(987654321);
+  buf.PutLong(1530000000000);
+}
+
+static void BM_ByteBufferPutInt(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  int value = 0;
+  for (auto _ : state) {
+    if (buf.remaining() < (int)sizeof(int)) {
+      buf.Clear();
+    }
+    buf.PutInt(value++);
+  }
+  benchmark::DoNotOptimize(buf.get_bytes());
+}
+BENCHMARK(BM_ByteBufferPutInt);
+
+static void BM_ByteBufferPutLong(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  long long value = 0;
+  for (auto _ : state) {
+    if (buf.remaining() < (int)sizeof(long long)) {
+      buf.Clear();
+    }
+    buf.PutLong(value++);
+  }
+  benchmark::DoNotOptimize(buf.get_bytes());
+}
+BENCHMARK(BM_ByteBufferPutLong);
+
+static void BM_ByteBufferGetInt(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  for (int i = 0; buf.remaining() >= (int)sizeof(int); i++) {
+    buf.PutInt(i);
+  }
+  buf.Clear();
+  for (auto _ : state) {
+    if (buf.remaining() < (int)sizeof(int)) {
+      buf.Clear();
+    }
+    benchmark::DoNotOptimize(buf.GetInt());
+  }
+}
+BENCHMARK(BM_ByteBufferGetInt);
+
+static void BM_ByteBufferGetLong(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  for (long long i = 0; buf.remaining() >= (int)sizeof(long long); i++) {
+    buf.PutLong(i);
+  }
+  buf.Clear();
+  for (auto _ : state) {
+    if (buf.remaining() < (int)sizeof(long long)) {
+      buf.Clear();
+    }
+    benchmark::DoNotOptimize(buf.GetLong());
+  }
+}
+BENCHMARK(BM_ByteBufferGetLong);
+
+static void BM_FileHash(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(file_hash(kName));
+  }
+}
+BENCHMARK(BM_FileHash);
+
+static void BM_FilenameConstruct(benchmark::State &state) {
+  for (auto _ : state) {
+    Filename filename(kName);
+    benchmark::DoNotOptimize(filename.component());
+  }
+}
+BENCHMARK(BM_FilenameConstruct);
+
+static void BM_FilenameSet(benchmark::State &state) {
+  Filename filename;
+  for (auto _ : state) {
+    filename.Set(kName);
+    benchmark::DoNotOptimize(filename.component());
+  }
+}
+BENCHMARK(BM_FilenameSet);
+
+static void BM_FilenameWrite(benchmark::State &state) {
+  Filename filename(kName);
+  ByteBuffer buf(kScratchSize);
+  for (auto _ : state) {
+    buf.Clear();
+    filename.Write(buf);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_FilenameWrite);
+
+static void BM_FilenameWriteCompact(benchmark::State &state) {
+  Filename filename(kName);
+  ByteBuffer buf(kScratchSize);
+  for (auto _ : state) {
+    buf.Clear();
+    filename.WriteCompact(buf);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_FilenameWriteCompact);
+
+static void BM_CreateRequestWrite(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  for (auto _ : state) {
+    Filename filename(kName);
+    Createrequest request(filename, 0, 0, 0, 1);
+    buf.Clear();
+    request.Write(buf);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_CreateRequestWrite);
+
+static void BM_DatanodeInfoUpdate(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  WriteDatanodeInfo(buf);
+  DatanodeInfo info;
+  for (auto _ : state) {
+    buf.Clear();
+    info.Update(buf);
+    benchmark::DoNotOptimize(info.port());
+  }
+}
+BENCHMARK(BM_DatanodeInfoUpdate);
+
+static void BM_BlockInfoUpdate(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  WriteBlockInfo(buf);
+  BlockInfo info;
+  for (auto _ : state) {
+    buf.Clear();
+    info.Update(buf);
+    benchmark::DoNotOptimize(info.addr());
+  }
+}
+BENCHMARK(BM_BlockInfoUpdate);
+
+static void BM_FileInfoUpdate(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  WriteFileInfo(buf);
+  FileInfo info;
+  for (auto _ : state) {
+    buf.Clear();
+    info.Update(buf);
+    benchmark::DoNotOptimize(info.fd());
+  }
+}
+BENCHMARK(BM_FileInfoUpdate);
+
+static void BM_LookupResponseUpdate(benchmark::State &state) {
+  ByteBuffer buf(kScratchSize);
+  buf.PutShort(3);
+  buf.PutShort(0);
+  WriteFileInfo(buf);
+  WriteBlockInfo(buf);
+  for (auto _ : state) {
+    LookupResponse response(nullptr);
+    buf.Clear();
+    response.Update(buf);
+    benchmark::DoNotOptimize(response.file()->fd());
+  }
+}
+BENCHMARK(BM_LookupResponseUpdate);
+
+static void BM_DirectoryRecordWrite(benchmark::State &state) {
+  string name = kName.substr(kName.rfind('/') + 1);
+  DirectoryRecord record(1, name);
+  ByteBuffer buf(kDirectoryRecord);
+  for (auto _ : state) {
+    buf.Clear();
+    record.Write(buf);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_DirectoryRecordWrite);
+
+static void BM_DirectoryRecordUpdate(benchmark::State &state) {
+  string name = kName.substr(kName.rfind('/') + 1);
+  DirectoryRecord written(1, name);
+  ByteBuffer buf(kDirectoryRecord);
+  written.Write(buf);
+  DirectoryRecord record;
+  for (auto _ : state) {
+    buf.Clear();
+    record.Update(buf);
+    benchmark::DoNotOptimize(record.name().data());
+  }
+}
+BENCHMARK(BM_DirectoryRecordUpdate);
+
+BENCHMARK_MAIN();
@@ -96,14 +96,31 @@ def deregister_job(jobid):
 
 
 
-def connect(hostname, port):
+def connect(hostname, port, deferred_close=False, lookup_ttl=0, negative_ttl=0):
   pocketHandle = libpocket.PocketDispatcher()
   res = pocketHandle.Initialize(hostname, port)
   if res != 0:
     print("Connecting to metadata server failed!")
+  # puts return before the namenode acknowledged them, see flush()
+  pocketHandle.SetDeferredClose(deferred_close)
+  # milliseconds a lookup result (or a missing key) is reused without asking
+  # the metadata server, keys written by other jobs show up at most this late
+  pocketHandle.SetLookupTtl(lookup_ttl)
+  pocketHandle.SetNegativeTtl(negative_ttl)
 
   return pocketHandle
 
+
+def flush(pocket):
+  '''
+  Complete the puts of a handle connected with deferred_close=True, they
+  are visible to other clients once this returns
+
+  :param pocket:           pocketHandle returned from connect()
+  :return: 0 if every deferred put completed, -1 otherwise
+  '''
+  return pocket.Flush()
+
 def put(pocket, src_filename, dst_filename, jobid, PERSIST_AFTER_JOB=False):  
   '''
   Send a PUT request to Pocket to write key
@@ -129,12 +146,23 @@ def put(pocket, src_filename, dst_filename, jobid, PERSIST_AFTER_JOB=False):
   return res
 
 
+def _byte_view(obj, len):
+  '''
+  Flat byte view on the first len bytes of obj if it exports the buffer
+  protocol (bytes, bytearray, memoryview, numpy), None otherwise
+  '''
+  try:
+    return memoryview(obj).cast('B')[:len]
+  except TypeError:
+    return None
+
+
 def put_buffer(pocket, src, len, dst_filename, jobid, PERSIST_AFTER_JOB=False):
   '''
   Send a PUT request to Pocket to write key
 
   :param pocket:           pocketHandle returned from connect()
-  :param str src: 	   name of local object containing data to PUT
+  :param src:              bytes-like object (or str) containing data to PUT
   :param str dst_filename: name of file/key in Pocket which writing to
   :param str jobid:        id unique to this job, used to separate keyspace for job
   :param PERSIST_AFTER_JOB:optional hint, if True, data written to table persisted after job done
@@ -149,7 +177,11 @@ def put_buffer(pocket, src, len, dst_filename, jobid, PERSIST_AFTER_JOB=False):
   else:
     set_filename = jobid + "/" + dst_filename
 
-  res = pocket.PutBuffer(src, len, set_filename, False)
+  view = _byte_view(src, len)
+  if view is not None:
+    res = pocket.PutBufferView(view, set_filename, False)
+  else:
+    res = pocket.PutBuffer(src, len, set_filename, False)
 
   return res
 
@@ -188,7 +220,8 @@ def get_buffer(pocket, src_filename, dst, len, jobid, DELETE_AFTER_READ=False):
 
   :param pocket:           pocketHandle returned from connect()
   :param str src_filename: name of file/key in Pocket from which reading
-  :param str dst: name of local object  where want to store data from GET
+  :param dst:              writable bytes-like object (bytearray, memoryview,
+                           numpy array) the data is read into
   :param str jobid:        id unique to this job, used to separate keyspace for job
   :param DELETE_AFTER_READ:optional hint, if True, data deleted after job done
   :return: the Pocket dispatcher response 
@@ -199,7 +232,11 @@ def get_buffer(pocket, src_filename, dst, len, jobid, DELETE_AFTER_READ=False):
   
   get_filename = jobid + "/" + src_filename
 
-  res = pocket.GetBuffer(dst, len, get_filename)
+  view = _byte_view(dst, len)
+  if view is not None and not view.readonly:
+    res = pocket.GetBufferView(view, get_filename)
+  else:
+    res = pocket.GetBuffer(dst, len, get_filename)
   if res != 0:
     print("GET BUFFER failed!")
     return res
@@ -210,6 +247,60 @@ def get_buffer(pocket, src_filename, dst, len, jobid, DELETE_AFTER_READ=False):
   return res
 
 
+def multi_put(pocket, srcs, dst_filenames, jobid, PERSIST_AFTER_JOB=False):
+  '''
+  Send PUT requests for several keys at once, the namenode and storage
+  requests of all keys are pipelined instead of paying a round-trip per key
+
+  :param pocket:           pocketHandle returned from connect()
+  :param srcs:             list of bytes-like objects containing data to PUT
+  :param dst_filenames:    list of names of files/keys in Pocket, one per src
+  :param str jobid:        id unique to this job, used to separate keyspace for job
+  :param PERSIST_AFTER_JOB:optional hint, if True, data written to table persisted after job done
+  :return: 0 if every key was written, -1 otherwise
+  '''
+
+  if jobid:
+    jobid = "/" + jobid
+
+  if PERSIST_AFTER_JOB:
+    prefix = jobid + "-persist/"
+  else:
+    prefix = jobid + "/"
+
+  set_filenames = [prefix + dst_filename for dst_filename in dst_filenames]
+  views = [memoryview(src).cast('B') for src in srcs]
+  return pocket.MultiPutView(views, set_filenames, False)
+
+
+def multi_get(pocket, src_filenames, dsts, jobid, DELETE_AFTER_READ=False):
+  '''
+  Send GET requests for several keys at once, the counterpart of multi_put()
+
+  :param pocket:           pocketHandle returned from connect()
+  :param src_filenames:    list of names of files/keys in Pocket to read
+  :param dsts:             list of writable bytes-like objects, one per key,
+                           each sized to the length of its key
+  :param str jobid:        id unique to this job, used to separate keyspace for job
+  :param DELETE_AFTER_READ:optional hint, if True, data deleted after job done
+  :return: 0 if every key was read, -1 otherwise
+  '''
+
+  prefix = "/" + jobid + "/" if jobid else "/"
+  get_filenames = [prefix + src_filename for src_filename in src_filenames]
+  views = [memoryview(dst).cast('B') for dst in dsts]
+  res = pocket.MultiGetView(views, get_filenames)
+  if res != 0:
+    print("MULTI GET failed!")
+    return res
+
+  if DELETE_AFTER_READ:
+    if delete_many(pocket, src_filenames, jobid) != 0:
+      res = -1
+
+  return res
+
+
 def lookup(pocket, src_filename, jobid):  
   '''
   Send a LOOKUP metadata request to Pocket to see if file exists
@@ -256,6 +347,47 @@ def delete(pocket, src_filename, jobid):
   return res
 
 
+def delete_many(pocket, src_filenames, jobid):
+  '''
+  Send DEL requests for several keys at once, the requests share namenode
+  messages and the directory updates are written in one go
+
+  :param pocket:           pocketHandle returned from connect()
+  :param src_filenames:    list of names of files/keys in Pocket to delete
+  :param str jobid:        id unique to this job, used to separate keyspace for job
+  :return: 0 if every key was deleted, -1 otherwise
+  '''
+
+  prefix = "/" + jobid + "/" if jobid else "/"
+  names = [prefix + src_filename for src_filename in src_filenames]
+  return pocket.DeleteFiles(names, True) # recursive delete
+
+
+def list_dir(pocket, dirname, jobid):
+  '''
+  List the keys of a directory, only keys PUT with enumerable set show up
+
+  :param pocket:           pocketHandle returned from connect()
+  :param str dirname:      name of the directory, "" for the job's directory
+  :param str jobid:        id unique to this job, used to separate keyspace for job
+  :return: list of key names, None if the directory can't be read
+  '''
+
+  if jobid:
+    jobid = "/" + jobid
+
+  if dirname:
+    dirname = jobid + "/" + dirname
+  else:
+    dirname = jobid
+
+  names = pocket.List(dirname)
+  if names is None:
+    print("LIST failed!")
+
+  return names
+
+
 def create_dir(pocket, src_filename, jobid):  
   '''
   Send a CREATE DIRECTORY request to Pocket
@@ -301,6 +433,22 @@ def count_files(pocket, dirname, jobid):
   return res
 
 
+def stats(pocket, reset=False):
+  '''
+  Latency and byte counters of the client operations of this process
+
+  :param pocket:           pocketHandle returned from connect()
+  :param reset:            optional, start counting from zero afterwards
+  :return: dict from operation name (namenode_* and storage_* are single
+           RPCs, put/get whole calls) to a dict with count, bytes and
+           mean/p50/p99/p999/max latency in microseconds
+  '''
+  res = pocket.Stats()
+  if reset:
+    pocket.ResetStats()
+  return res
+
+
 def close(pocket):  
   '''
   Send a CLOSE request to PocketFS
@@ -26,13 +26,15 @@
 #include <iostream>
 #include <string.h>
 
+#include "common/buffer_pool.h"
+#include "common/client_stats.h"
 #include "crail_directory.h"
 #include "crail_file.h"
 #include "crail_outputstream.h"
 
 using namespace std;
 
-PocketDispatcher::PocketDispatcher() {}
+PocketDispatcher::PocketDispatcher() : deferred_close_(false) {}
 
 PocketDispatcher::~PocketDispatcher() {}
 
@@ -76,8 +78,25 @@ int PocketDispatcher::Enumerate(string name) {
   return 0;
 }
 
+int PocketDispatcher::List(string name, vector<string> &names) {
+  unique_ptr<CrailNode> crail_node = crail_.Lookup(name);
+  if (!crail_node) {
+    cout << "lookup node failed" << endl;
+    return -1;
+  }
+  if (crail_node->type() != static_cast<int>(FileType::Directory)) {
+    cout << "node is not a directory" << endl;
+    return -1;
+  }
+
+  CrailNode *node = crail_node.get();
+  CrailDirectory *directory = static_cast<CrailDirectory *>(node);
+  return directory->List(names);
+}
+
 int PocketDispatcher::PutFile(string local_file, string dst_file,
                               bool enumerable) {
+  StatTimer timer(Stat::Put);
   FILE *fp = fopen(local_file.c_str(), "r");
   if (!fp) {
     cout << "could not open local file " << local_file.c_str() << endl;
@@ -99,7 +118,7 @@ int PocketDispatcher::PutFile(string local_file, string dst_file,
   CrailFile *file = static_cast<CrailFile *>(node);
   unique_ptr<CrailOutputstream> outputstream = file->outputstream();
 
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(kBufferSize);
+  shared_ptr<ByteBuffer> buf = BufferPool::Instance().Get(kBufferSize);
   while (size_t len = fread(buf->get_bytes(), 1, buf->remaining(), fp)) {
     buf->set_position(buf->position() + len);
     if (buf->remaining() > 0) {
@@ -125,12 +144,16 @@ int PocketDispatcher::PutFile(string local_file, string dst_file,
   }
 
   fclose(fp);
+  if (deferred_close_) {
+    return crail_.CloseDeferred(move(outputstream));
+  }
   outputstream->Close();
 
   return 0;
 }
 
 int PocketDispatcher::GetFile(string src_file, string local_file) {
+  StatTimer timer(Stat::Get);
   unique_ptr<CrailNode> crail_node = crail_.Lookup(src_file);
   if (!crail_node) {
     cout << "lookup node failed" << endl;
@@ -151,7 +174,7 @@ int PocketDispatcher::GetFile(string src_file, string local_file) {
   CrailFile *file = static_cast<CrailFile *>(node);
   unique_ptr<CrailInputstream> inputstream = file->inputstream();
 
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(kBufferSize);
+  shared_ptr<ByteBuffer> buf = BufferPool::Instance().Get(kBufferSize);
   while (inputstream->Read(buf) > 0) {
     buf->Flip();
     while (buf->remaining()) {
@@ -173,6 +196,137 @@ int PocketDispatcher::DeleteDir(string directory) {
   return crail_.Remove(directory, true);
 }
 
+int PocketDispatcher::DeleteFiles(vector<string> &files, bool recursive) {
+  return crail_.Remove(files, recursive);
+}
+
+int PocketDispatcher::MultiPut(vector<string> &dst_files,
+                              vector<const char *> &data, vector<int> &lengths,
+                              bool enumerable) {
+  if (data.size() != dst_files.size() || lengths.size() != dst_files.size()) {
+    cout << "mismatched multi put arguments" << endl;
+    return -1;
+  }
+
+  // every phase is issued for all keys before any of them is awaited
+  vector<unique_ptr<CrailNode>> crail_nodes =
+      crail_.Create(dst_files, FileType::File, 0, 0, enumerable);
+  int res = 0;
+  vector<unique_ptr<CrailOutputstream>> outputstreams;
+  vector<string> written_files;
+  vector<string> failed;
+  for (unsigned i = 0; i < crail_nodes.size(); i++) {
+    if (!crail_nodes[i]) {
+      cout << "create node failed " << dst_files[i] << endl;
+      res = -1;
+      continue;
+    }
+    if (crail_nodes[i]->type() != static_cast<int>(FileType::File)) {
+      cout << "node is not a file " << dst_files[i] << endl;
+      res = -1;
+      continue;
+    }
+
+    CrailFile *file = static_cast<CrailFile *>(crail_nodes[i].get());
+    unique_ptr<CrailOutputstream> outputstream = file->outputstream();
+    shared_ptr<ByteBuffer> buf =
+        make_shared<ByteBuffer>((unsigned char *)data[i], lengths[i]);
+    bool written = true;
+    while (buf->remaining() > 0) {
+      if (outputstream->Write(buf) < 0) {
+        written = false;
+        break;
+      }
+    }
+    // a partly written stream is dropped without committing its capacity
+    if (!written) {
+      cout << "write failed " << dst_files[i] << endl;
+      failed.push_back(dst_files[i]);
+      res = -1;
+      continue;
+    }
+    outputstreams.push_back(move(outputstream));
+    written_files.push_back(dst_files[i]);
+  }
+
+  // most write errors only surface when a stream is closed, those keys
+  // are removed along with the ones whose write failed right away
+  vector<shared_ptr<Future>> closes(outputstreams.size());
+  for (unsigned i = 0; i < outputstreams.size(); i++) {
+    if (deferred_close_) {
+      if (crail_.CloseDeferred(move(outputstreams[i])) < 0) {
+        cout << "close failed " << written_files[i] << endl;
+        failed.push_back(written_files[i]);
+        res = -1;
+      }
+      continue;
+    }
+    closes[i] = outputstreams[i]->CloseAsync();
+  }
+  for (unsigned i = 0; i < closes.size(); i++) {
+    if (deferred_close_) {
+      continue;
+    }
+    if (!closes[i] || closes[i]->Get() < 0) {
+      cout << "close failed " << written_files[i] << endl;
+      failed.push_back(written_files[i]);
+      res = -1;
+    }
+  }
+  if (!failed.empty()) {
+    crail_.Remove(failed, false);
+  }
+
+  return res;
+}
+
+int PocketDispatcher::MultiGet(vector<string> &src_files, vector<char *> &data,
+                              vector<int> &lengths) {
+  if (data.size() != src_files.size() || lengths.size() != src_files.size()) {
+    cout << "mismatched multi get arguments" << endl;
+    return -1;
+  }
+
+  vector<unique_ptr<CrailNode>> crail_nodes = crail_.Lookup(src_files);
+  int res = 0;
+  vector<unique_ptr<CrailInputstream>> inputstreams;
+  vector<shared_ptr<Future>> reads;
+  for (unsigned i = 0; i < crail_nodes.size(); i++) {
+    if (!crail_nodes[i]) {
+      cout << "lookup node failed " << src_files[i] << endl;
+      res = -1;
+      continue;
+    }
+    if (crail_nodes[i]->type() != static_cast<int>(FileType::File)) {
+      cout << "node is not a file " << src_files[i] << endl;
+      res = -1;
+      continue;
+    }
+
+    CrailFile *file = static_cast<CrailFile *>(crail_nodes[i].get());
+    unique_ptr<CrailInputstream> inputstream = file->inputstream();
+    shared_ptr<ByteBuffer> buf =
+        make_shared<ByteBuffer>((unsigned char *)data[i], lengths[i]);
+    shared_ptr<Future> read = inputstream->ReadAsync(buf);
+    if (!read || buf->remaining() > 0) {
+      // the file is shorter than the buffer, same as GetBuffer
+      res = -1;
+    }
+    if (read) {
+      reads.push_back(read);
+    }
+    inputstreams.push_back(move(inputstream));
+  }
+
+  for (shared_ptr<Future> &read : reads) {
+    if (read->Get() < 0) {
+      res = -1;
+    }
+  }
+
+  return res;
+}
+
 int PocketDispatcher::DeleteFile(string file) {
   return crail_.Remove(file, false);
 }
@@ -182,8 +336,20 @@ int PocketDispatcher::CountFiles(string directory) {
   return crail_.Ioctl((unsigned char)op, directory);
 }
 
+int PocketDispatcher::Flush() { return crail_.Flush(); }
+
+string PocketDispatcher::DumpStats() { return ClientStats::Instance().Dump(); }
+
+void PocketDispatcher::SnapshotStats(vector<StatSummary> &summaries) {
+  ClientStats::Instance().Snapshot(summaries);
+}
+
+void PocketDispatcher::ResetStats() { ClientStats::Instance().Reset(); }
+
 int PocketDispatcher::PutBuffer(const char data[], int len, string dst_file,
                                 bool enumerable) {
+  StatTimer timer(Stat::Put);
+  timer.set_bytes(len);
   unique_ptr<CrailNode> crail_node =
       crail_.Create(dst_file, FileType::File, 0, 0, enumerable);
   if (!crail_node) {
@@ -199,20 +365,25 @@ int PocketDispatcher::PutBuffer(const char data[], int len, string dst_file,
   CrailFile *file = static_cast<CrailFile *>(node);
   unique_ptr<CrailOutputstream> outputstream = file->outputstream();
 
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(len);
-  buf->PutBytes(data, len);
-  buf->Flip();
+  // write straight from the caller's memory
+  shared_ptr<ByteBuffer> buf =
+      make_shared<ByteBuffer>((unsigned char *)data, len);
   while (buf->remaining() > 0) {
     if (outputstream->Write(buf) < 0) {
       return -1;
     }
   }
+  if (deferred_close_) {
+    return crail_.CloseDeferred(move(outputstream));
+  }
   outputstream->Close();
 
   return 0;
 }
 
 int PocketDispatcher::GetBuffer(char data[], int len, string src_file) {
+  StatTimer timer(Stat::Get);
+  timer.set_bytes(len);
   unique_ptr<CrailNode> crail_node = crail_.Lookup(src_file);
   if (!crail_node) {
     cout << "lookup node failed" << endl;
@@ -227,14 +398,17 @@ int PocketDispatcher::GetBuffer(char data[], int len, string src_file) {
   CrailFile *file = static_cast<CrailFile *>(node);
   unique_ptr<CrailInputstream> inputstream = file->inputstream();
 
-  shared_ptr<ByteBuffer> buf = make_shared<ByteBuffer>(len);
-  while (buf->remaining()) {
-    if (inputstream->Read(buf) < 0) {
-      return -1;
-    }
+  // every block is read straight into the caller's memory
+  shared_ptr<ByteBuffer> buf =
+      make_shared<ByteBuffer>((unsigned char *)data, len);
+  shared_ptr<Future> read = inputstream->ReadAsync(buf);
+  if (!read || read->Get() < 0) {
+    return -1;
+  }
+  if (buf->remaining() > 0) {
+    // the file is shorter than the buffer
+    return -1;
   }
-  buf->Clear();
-  memcpy(data, buf->get_bytes(), len);
 
   inputstream->Close();
 
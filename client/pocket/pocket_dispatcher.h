@@ -25,7 +25,9 @@
 #define CRAIL_DISPATCHER_H
 
 #include <string>
+#include <vector>
 
+#include "common/client_stats.h"
 #include "crail_store.h"
 
 using namespace std;
@@ -40,16 +42,39 @@ public:
   int MakeDir(string name);
   int Lookup(string name);
   int Enumerate(string name);
+  int List(string name, vector<string> &names);
   int PutFile(string local_file, string dst_file, bool enumerable);
   int GetFile(string src_file, string local_file);
   int PutBuffer(const char buf[], int len, string dst_file, bool enumerable);
   int GetBuffer(char buf[], int len, string src_file);
+  int MultiPut(vector<string> &dst_files, vector<const char *> &data,
+               vector<int> &lengths, bool enumerable);
+  int MultiGet(vector<string> &src_files, vector<char *> &data,
+               vector<int> &lengths);
   int DeleteFile(string file);
   int DeleteDir(string directory);
+  int DeleteFiles(vector<string> &files, bool recursive);
   int CountFiles(string directory);
+  int Flush();
+  // latency and byte counts of all client operations of the process
+  string DumpStats();
+  void SnapshotStats(vector<StatSummary> &summaries);
+  void ResetStats();
+
+  // puts return once the data is stored, their namenode update is batched
+  // and completed by Flush or the next lookup
+  void set_deferred_close(bool deferred_close) {
+    this->deferred_close_ = deferred_close;
+  }
+  bool deferred_close() const { return deferred_close_; }
+
+  // milliseconds lookups and missing names are cached, 0 disables
+  void set_lookup_ttl(int ttl) { crail_.set_lookup_ttl(ttl); }
+  void set_negative_ttl(int ttl) { crail_.set_negative_ttl(ttl); }
 
 private:
   CrailStore crail_;
+  bool deferred_close_;
 };
 
 #endif /* CRAIL_DISPATCHER_H */
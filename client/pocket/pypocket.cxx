@@ -1,21 +1,214 @@
 #include <boost/python.hpp>
+#include <climits>
+#include <vector>
+#include "common/client_stats.h"
 #include "pocket_dispatcher.h"
 
+using namespace boost::python;
+
+// Zero-copy variants taking any object that exports the buffer protocol
+// (bytes, bytearray, memoryview, numpy arrays). The data is moved straight
+// between the Python object and the network with the GIL released.
+static int PutBufferView(PocketDispatcher &dispatcher, object src,
+		string dst_file, bool enumerable)
+{
+	Py_buffer view;
+	if (PyObject_GetBuffer(src.ptr(), &view, PyBUF_SIMPLE) < 0) {
+		throw_error_already_set();
+	}
+	if (view.len > INT_MAX) {
+		PyBuffer_Release(&view);
+		PyErr_SetString(PyExc_ValueError, "buffer too large");
+		throw_error_already_set();
+	}
+
+	int res;
+	Py_BEGIN_ALLOW_THREADS
+	res = dispatcher.PutBuffer((const char *) view.buf, (int) view.len,
+			dst_file, enumerable);
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&view);
+	return res;
+}
+
+static int GetBufferView(PocketDispatcher &dispatcher, object dst,
+		string src_file)
+{
+	Py_buffer view;
+	if (PyObject_GetBuffer(dst.ptr(), &view, PyBUF_WRITABLE) < 0) {
+		throw_error_already_set();
+	}
+	if (view.len > INT_MAX) {
+		PyBuffer_Release(&view);
+		PyErr_SetString(PyExc_ValueError, "buffer too large");
+		throw_error_already_set();
+	}
+
+	int res;
+	Py_BEGIN_ALLOW_THREADS
+	res = dispatcher.GetBuffer((char *) view.buf, (int) view.len, src_file);
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&view);
+	return res;
+}
+
+// Acquires a view of every object in objs, releasing the ones already taken
+// if any of them fails.
+static void GetBufferViews(boost::python::list objs, int flags,
+		vector<Py_buffer> &views)
+{
+	int count = len(objs);
+	views.resize(count);
+	for (int i = 0; i < count; i++) {
+		object obj = objs[i];
+		bool ok = PyObject_GetBuffer(obj.ptr(), &views[i], flags) == 0;
+		if (ok && views[i].len > INT_MAX) {
+			PyBuffer_Release(&views[i]);
+			PyErr_SetString(PyExc_ValueError, "buffer too large");
+			ok = false;
+		}
+		if (!ok) {
+			for (int j = 0; j < i; j++) {
+				PyBuffer_Release(&views[j]);
+			}
+			throw_error_already_set();
+		}
+	}
+}
+
+static int MultiPutView(PocketDispatcher &dispatcher, boost::python::list srcs,
+		boost::python::list dst_files, bool enumerable)
+{
+	vector<string> names;
+	for (int i = 0; i < len(dst_files); i++) {
+		names.push_back(extract<string>(dst_files[i]));
+	}
+	vector<Py_buffer> views;
+	GetBufferViews(srcs, PyBUF_SIMPLE, views);
+	vector<const char *> data;
+	vector<int> lengths;
+	for (Py_buffer &view : views) {
+		data.push_back((const char *) view.buf);
+		lengths.push_back((int) view.len);
+	}
+
+	int res;
+	Py_BEGIN_ALLOW_THREADS
+	res = dispatcher.MultiPut(names, data, lengths, enumerable);
+	Py_END_ALLOW_THREADS
+	for (Py_buffer &view : views) {
+		PyBuffer_Release(&view);
+	}
+	return res;
+}
+
+static int MultiGetView(PocketDispatcher &dispatcher, boost::python::list dsts,
+		boost::python::list src_files)
+{
+	vector<string> names;
+	for (int i = 0; i < len(src_files); i++) {
+		names.push_back(extract<string>(src_files[i]));
+	}
+	vector<Py_buffer> views;
+	GetBufferViews(dsts, PyBUF_WRITABLE, views);
+	vector<char *> data;
+	vector<int> lengths;
+	for (Py_buffer &view : views) {
+		data.push_back((char *) view.buf);
+		lengths.push_back((int) view.len);
+	}
+
+	int res;
+	Py_BEGIN_ALLOW_THREADS
+	res = dispatcher.MultiGet(names, data, lengths);
+	Py_END_ALLOW_THREADS
+	for (Py_buffer &view : views) {
+		PyBuffer_Release(&view);
+	}
+	return res;
+}
+
+static int DeleteFiles(PocketDispatcher &dispatcher,
+		boost::python::list files, bool recursive)
+{
+	vector<string> names;
+	for (int i = 0; i < len(files); i++) {
+		names.push_back(extract<string>(files[i]));
+	}
+
+	int res;
+	Py_BEGIN_ALLOW_THREADS
+	res = dispatcher.DeleteFiles(names, recursive);
+	Py_END_ALLOW_THREADS
+	return res;
+}
+
+// Names of the enumerable files in a directory, None if it can't be read.
+static object List(PocketDispatcher &dispatcher, string name)
+{
+	vector<string> names;
+	int res;
+	Py_BEGIN_ALLOW_THREADS
+	res = dispatcher.List(name, names);
+	Py_END_ALLOW_THREADS
+	if (res < 0) {
+		return object();
+	}
+
+	boost::python::list result;
+	for (string &entry : names) {
+		result.append(entry);
+	}
+	return result;
+}
+
+// Per operation counters of the process, latencies in microseconds.
+static dict Stats(PocketDispatcher &dispatcher)
+{
+	vector<StatSummary> summaries;
+	dispatcher.SnapshotStats(summaries);
+	dict result;
+	for (StatSummary &summary : summaries) {
+		dict entry;
+		entry["count"] = summary.count;
+		entry["bytes"] = summary.bytes;
+		entry["mean_us"] = summary.mean / 1000.0;
+		entry["p50_us"] = summary.p50 / 1000.0;
+		entry["p99_us"] = summary.p99 / 1000.0;
+		entry["p999_us"] = summary.p999 / 1000.0;
+		entry["max_us"] = summary.max / 1000.0;
+		result[summary.name] = entry;
+	}
+	return result;
+}
+
 BOOST_PYTHON_MODULE(libpocket)
 {
-	using namespace boost::python;
-		class_<PocketDispatcher>("PocketDispatcher")
+		class_<PocketDispatcher, boost::noncopyable>("PocketDispatcher")
 			.def("Initialize", &PocketDispatcher::Initialize)
 			.def("MakeDir", &PocketDispatcher::MakeDir)
 			.def("Lookup", &PocketDispatcher::Lookup)
 			.def("Enumerate", &PocketDispatcher::Enumerate)
+			.def("List", &List)
 			.def("PutFile", &PocketDispatcher::PutFile)
 			.def("GetFile", &PocketDispatcher::GetFile)
 			.def("DeleteFile", &PocketDispatcher::DeleteFile)
 			.def("DeleteDir", &PocketDispatcher::DeleteDir)
+			.def("DeleteFiles", &DeleteFiles)
 			.def("PutBuffer", &PocketDispatcher::PutBuffer)
 			.def("GetBuffer", &PocketDispatcher::GetBuffer)
 			.def("CountFiles", &PocketDispatcher::CountFiles)
+			.def("PutBufferView", &PutBufferView)
+			.def("GetBufferView", &GetBufferView)
+			.def("MultiPutView", &MultiPutView)
+			.def("MultiGetView", &MultiGetView)
+			.def("Flush", &PocketDispatcher::Flush)
+			.def("Stats", &Stats)
+			.def("DumpStats", &PocketDispatcher::DumpStats)
+			.def("ResetStats", &PocketDispatcher::ResetStats)
+			.def("SetDeferredClose", &PocketDispatcher::set_deferred_close)
+			.def("SetLookupTtl", &PocketDispatcher::set_lookup_ttl)
+			.def("SetNegativeTtl", &PocketDispatcher::set_negative_ttl)
 		;
 
 	
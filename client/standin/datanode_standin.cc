@@ -0,0 +1,119 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "datanode_standin.h"
+
+#include <string.h>
+
+#include "common/byte_buffer.h"
+#include "common/crail_constants.h"
+#include "narpc/rpc_client.h"
+
+using namespace std;
+using namespace crail;
+
+DatanodeStandin::DatanodeStandin(long long capacity)
+    : capacity_(capacity), memory_(new unsigned char[capacity]) {}
+
+DatanodeStandin::~DatanodeStandin() {}
+
+void DatanodeStandin::Serve(int socket) {
+  ByteBuffer header(RpcClient::kNarpcHeader + 64);
+  unique_ptr<unsigned char[]> data(new unsigned char[kBlockSize]);
+
+  while (true) {
+    header.Clear();
+    if (RecvBytes(socket, header.get_bytes(), RpcClient::kNarpcHeader) < 0) {
+      return;
+    }
+    int size = header.GetInt();
+    long long ticket = header.GetLong();
+
+    // type, key, address, length
+    int fields = 4 + 4 + 8 + 4;
+    header.Clear();
+    if (size < fields || RecvBytes(socket, header.get_bytes(), fields) < 0) {
+      return;
+    }
+    int type = header.GetInt();
+    header.GetInt();
+    long long address = header.GetLong();
+    int length = header.GetInt();
+    if (length < 0 || length > kBlockSize) {
+      return;
+    }
+    int error = 0;
+    if (address < 0 || address + length > capacity_) {
+      error = 1;
+    }
+
+    if (type == kReqWrite) {
+      header.Clear();
+      if (RecvBytes(socket, header.get_bytes(), 4) < 0) {
+        return;
+      }
+      int remaining = header.GetInt();
+      if (remaining < 0 || remaining > kBlockSize) {
+        return;
+      }
+      if (RecvBytes(socket, data.get(), remaining) < 0) {
+        return;
+      }
+      if (error == 0) {
+        memcpy(memory_.get() + address, data.get(), length);
+      }
+
+      header.Clear();
+      header.PutInt(12);
+      header.PutLong(ticket);
+      header.PutInt(error);
+      header.PutInt(type);
+      header.PutInt(length);
+      header.Flip();
+      if (SendBytes(socket, header.get_bytes(), header.remaining()) < 0) {
+        return;
+      }
+    } else if (type == kReqRead) {
+      header.Clear();
+      header.PutInt(12 + length);
+      header.PutLong(ticket);
+      header.PutInt(error);
+      header.PutInt(type);
+      header.PutInt(length);
+      header.Flip();
+      if (SendBytes(socket, header.get_bytes(), header.remaining()) < 0) {
+        return;
+      }
+      unsigned char *src = memory_.get() + address;
+      if (error != 0) {
+        memset(data.get(), 0, length);
+        src = data.get();
+      }
+      if (SendBytes(socket, src, length) < 0) {
+        return;
+      }
+    } else {
+      return;
+    }
+  }
+}
@@ -0,0 +1,53 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DATANODE_STANDIN_H
+#define DATANODE_STANDIN_H
+
+#include <memory>
+
+#include "standin_server.h"
+
+namespace crail {
+
+// DRAM datanode speaking the NaRPC storage protocol (TcpStorageServer).
+class DatanodeStandin : public StandinServer {
+public:
+  DatanodeStandin(long long capacity);
+  virtual ~DatanodeStandin();
+
+  static const int kReqRead = 1;
+  static const int kReqWrite = 2;
+
+  long long capacity() const { return capacity_; }
+
+protected:
+  void Serve(int socket);
+
+private:
+  long long capacity_;
+  unique_ptr<unsigned char[]> memory_;
+};
+} // namespace crail
+
+#endif /* DATANODE_STANDIN_H */
@@ -0,0 +1,558 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "namenode_standin.h"
+
+#include <chrono>
+#include <iostream>
+#include <string.h>
+
+#include "common/crail_constants.h"
+#include "narpc/rpc_client.h"
+
+using namespace std;
+using namespace crail;
+
+namespace {
+const short kCmdCreate = 1;
+const short kCmdLookup = 2;
+const short kCmdSetFile = 3;
+const short kCmdRemove = 4;
+const short kCmdGetBlock = 6;
+const short kCmdPing = 11;
+const short kCmdIoctl = 13;
+const short kCmdGetBlockRange = 15;
+
+const short kResVoid = 1;
+const short kResCreate = 2;
+const short kResLookup = 3;
+const short kResRemove = 4;
+const short kResGetBlock = 6;
+const short kResPing = 9;
+const short kResIoctl = 11;
+const short kResGetBlockRange = 12;
+
+const short kErrOk = 0;
+const short kErrProtocolMismatch = 2;
+const short kErrFileNotOpen = 6;
+const short kErrTokenMismatch = 7;
+const short kErrCapacityExceeded = 8;
+const short kErrPositionNegative = 9;
+const short kErrNoFreeBlocks = 11;
+const short kErrInvalidRpcCmd = 14;
+const short kErrParentMissing = 15;
+const short kErrParentNotDir = 16;
+const short kErrFileExists = 17;
+
+const int kNodeDirectory = 1;
+const unsigned char kIoctlCountFiles = 5;
+
+const int kMessageSize = 4096;
+
+long long CurrentTime() {
+  return chrono::duration_cast<chrono::milliseconds>(
+             chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+NamenodeStandin::NamenodeStandin()
+    : version_(kProtocolLegacy), root_(make_shared<Node>()), fd_counter_(0),
+      token_counter_(0), round_robin_(0) {
+  root_->fd = 0;
+  root_->type = kNodeDirectory;
+  root_->capacity = 0;
+  root_->dir_offset = -1;
+  root_->token = 0;
+  root_->modification_time = CurrentTime();
+  root_->storage_class = 0;
+  root_->next_dir_offset = 0;
+  fd_table_.insert({root_->fd, root_});
+}
+
+NamenodeStandin::~NamenodeStandin() {}
+
+int NamenodeStandin::AddDatanode(int address, int port, int storage_class,
+                                 long long size) {
+  lock_guard<mutex> guard(lock_);
+  Datanode datanode;
+  datanode.address = address;
+  datanode.port = port;
+  datanode.storage_class = storage_class;
+  datanode.next = 0;
+  datanode.size = size;
+  datanodes_.push_back(datanode);
+  return datanodes_.size() - 1;
+}
+
+void NamenodeStandin::Serve(int socket) {
+  ByteBuffer header(RpcClient::kNarpcHeader);
+  ByteBuffer request(kMessageSize);
+  ByteBuffer response(kMessageSize);
+
+  while (true) {
+    header.Clear();
+    if (RecvBytes(socket, header.get_bytes(), RpcClient::kNarpcHeader) < 0) {
+      return;
+    }
+    int size = header.GetInt();
+    long long ticket = header.GetLong();
+    if (size < 0 || size > kMessageSize) {
+      cout << "namenode stand-in, invalid message size " << size << endl;
+      return;
+    }
+
+    request.Clear();
+    if (RecvBytes(socket, request.get_bytes(), size) < 0) {
+      return;
+    }
+    request.set_limit(size);
+
+    response.Clear();
+    response.set_position(RpcClient::kNarpcHeader);
+    if (Process(request, response) < 0) {
+      return;
+    }
+    response.Flip();
+    response.PutInt(response.limit() - RpcClient::kNarpcHeader);
+    response.PutLong(ticket);
+    response.set_position(0);
+    if (SendBytes(socket, response.get_bytes(), response.remaining()) < 0) {
+      return;
+    }
+  }
+}
+
+int NamenodeStandin::Process(ByteBuffer &request, ByteBuffer &response) {
+  short cmd = request.GetShort();
+  unsigned short request_type = request.GetShort();
+
+  int start = response.position();
+  response.set_position(start + sizeof(short) * 2);
+
+  short type;
+  short error;
+  lock_guard<mutex> guard(lock_);
+  version_ = request_type >> 8;
+  switch (cmd) {
+  case kCmdCreate:
+    type = kResCreate;
+    error = Create(request, response);
+    break;
+  case kCmdLookup:
+    type = kResLookup;
+    error = Lookup(request, response);
+    break;
+  case kCmdSetFile:
+    type = kResVoid;
+    error = SetFile(request, response);
+    break;
+  case kCmdRemove:
+    type = kResRemove;
+    error = Remove(request, response);
+    break;
+  case kCmdGetBlock:
+    type = kResGetBlock;
+    error = GetBlock(request, response);
+    break;
+  case kCmdGetBlockRange:
+    type = kResGetBlockRange;
+    error = GetBlockRange(request, response);
+    break;
+  case kCmdPing:
+    type = kResPing;
+    error = Ping(request, response);
+    break;
+  case kCmdIoctl:
+    type = kResIoctl;
+    error = Ioctl(request, response);
+    break;
+  default:
+    type = kResVoid;
+    error = kErrInvalidRpcCmd;
+    break;
+  }
+
+  int end = response.position();
+  response.set_position(start);
+  response.PutShort(type);
+  response.PutShort(error);
+  response.set_position(end);
+  return 0;
+}
+
+short NamenodeStandin::Create(ByteBuffer &request, ByteBuffer &response) {
+  vector<int> components;
+  int length = ReadFilename(request, components);
+  int type = request.GetInt();
+  int storage_class = request.GetInt();
+  request.GetInt();
+  int enumerable = request.GetInt();
+
+  shared_ptr<Node> parent = nullptr;
+  shared_ptr<Node> node = nullptr;
+  short error = kErrOk;
+  if (length <= 0) {
+    error = kErrFileExists;
+  } else if (!(parent = Resolve(components, length - 1))) {
+    error = kErrParentMissing;
+  } else if (parent->type != kNodeDirectory) {
+    error = kErrParentNotDir;
+  } else if (parent->children.count(components[length - 1]) > 0) {
+    error = kErrFileExists;
+  }
+
+  if (error == kErrOk) {
+    node = make_shared<Node>();
+    node->fd = ++fd_counter_;
+    node->type = type;
+    node->capacity = 0;
+    node->dir_offset = -1;
+    node->token = 0;
+    node->modification_time = CurrentTime();
+    node->storage_class =
+        storage_class < 0 ? parent->storage_class : storage_class;
+    node->next_dir_offset = 0;
+    if (!AllocateBlock(*node, 0)) {
+      error = kErrNoFreeBlocks;
+      node = nullptr;
+    }
+  }
+
+  int parent_index = -1;
+  if (error == kErrOk) {
+    if (enumerable) {
+      node->dir_offset = parent->next_dir_offset;
+      parent->next_dir_offset += kDirectoryRecord;
+      parent->capacity += kDirectoryRecord;
+      parent_index = node->dir_offset / kBlockSize;
+      if (!AllocateBlock(*parent, parent_index)) {
+        ReleaseBlocks(*node);
+        error = kErrNoFreeBlocks;
+        node = nullptr;
+        parent_index = -1;
+      }
+    }
+  }
+
+  if (error == kErrOk) {
+    if (node->type != kNodeDirectory) {
+      node->token = ++token_counter_;
+    }
+    parent->children.insert({components[length - 1], node});
+    fd_table_.insert({node->fd, node});
+  }
+
+  WriteFileInfo(response, node.get(), true);
+  WriteFileInfo(response, parent.get(), false);
+  WriteBlockInfo(response, node.get(), 0);
+  WriteBlockInfo(response, parent.get(), parent_index);
+  return error;
+}
+
+short NamenodeStandin::Lookup(ByteBuffer &request, ByteBuffer &response) {
+  vector<int> components;
+  int length = ReadFilename(request, components);
+  request.GetInt();
+
+  shared_ptr<Node> node = Resolve(components, length);
+  WriteFileInfo(response, node.get(), false);
+  WriteBlockInfo(response, node.get(), 0);
+  return node ? kErrOk : kErrGetFileFailed;
+}
+
+short NamenodeStandin::SetFile(ByteBuffer &request, ByteBuffer &) {
+  long long fd = request.GetLong();
+  long long capacity = request.GetLong();
+  request.GetInt();
+  request.GetLong();
+  long long token = request.GetLong();
+  request.GetLong();
+  int close = request.GetInt();
+
+  auto iter = fd_table_.find(fd);
+  if (iter == fd_table_.end()) {
+    return kErrFileNotOpen;
+  }
+  shared_ptr<Node> node = iter->second;
+  if (node->token > 0 && node->token == token) {
+    node->capacity = capacity;
+  }
+  if (close) {
+    node->token = 0;
+  }
+  return kErrOk;
+}
+
+short NamenodeStandin::Remove(ByteBuffer &request, ByteBuffer &response) {
+  vector<int> components;
+  int length = ReadFilename(request, components);
+  request.GetInt();
+
+  shared_ptr<Node> parent = nullptr;
+  shared_ptr<Node> node = nullptr;
+  if (length > 0) {
+    parent = Resolve(components, length - 1);
+    node = Resolve(components, length);
+  }
+  WriteFileInfo(response, node.get(), false);
+  WriteFileInfo(response, parent.get(), false);
+  if (!parent || !node) {
+    return kErrGetFileFailed;
+  }
+
+  parent->children.erase(components[length - 1]);
+  ReleaseBlocks(*node);
+  return kErrOk;
+}
+
+short NamenodeStandin::GetBlock(ByteBuffer &request, ByteBuffer &response) {
+  long long fd = request.GetLong();
+  long long token = request.GetLong();
+  long long position = request.GetLong();
+  long long capacity = request.GetLong();
+
+  short error = kErrOk;
+  shared_ptr<Node> node = nullptr;
+  int index = position / kBlockSize;
+  auto iter = fd_table_.find(fd);
+  if (position < 0) {
+    error = kErrPositionNegative;
+  } else if (iter == fd_table_.end()) {
+    error = kErrFileNotOpen;
+  } else {
+    node = iter->second;
+    bool present = (size_t)index < node->blocks.size() &&
+                   node->blocks[index].datanode >= 0;
+    if (!present && node->token == token && token > 0) {
+      if (AllocateBlock(*node, index)) {
+        node->capacity = capacity;
+      } else {
+        error = kErrNoFreeBlocks;
+      }
+    } else if (!present && token > 0) {
+      error = kErrTokenMismatch;
+    } else if (!present) {
+      error = kErrCapacityExceeded;
+    }
+  }
+
+  WriteBlockInfo(response, error == kErrOk ? node.get() : nullptr, index);
+  return error;
+}
+
+short NamenodeStandin::GetBlockRange(ByteBuffer &request,
+                                     ByteBuffer &response) {
+  long long fd = request.GetLong();
+  request.GetLong();
+  long long position = request.GetLong();
+  long long length = request.GetLong();
+
+  auto iter = fd_table_.find(fd);
+  if (position < 0) {
+    response.PutInt(0);
+    return kErrPositionNegative;
+  }
+  if (iter == fd_table_.end()) {
+    response.PutInt(0);
+    return kErrFileNotOpen;
+  }
+  Node *node = iter->second.get();
+  int first = position / kBlockSize;
+  int last = (position + length - 1) / kBlockSize;
+  int count = 0;
+  while (count < 8 && first + count <= last &&
+         first + count < (int)node->blocks.size() &&
+         node->blocks[first + count].datanode >= 0) {
+    count++;
+  }
+  response.PutInt(count);
+  for (int i = 0; i < count; i++) {
+    WriteBlockInfo(response, node, first + i);
+  }
+  return kErrOk;
+}
+
+short NamenodeStandin::Ping(ByteBuffer &request, ByteBuffer &response) {
+  int op = request.GetInt();
+  if (op == kPingProtocolProbe) {
+    response.PutInt(op + 1 + kProtocolCompactFilename);
+  } else {
+    response.PutInt(op + 1);
+  }
+  return kErrOk;
+}
+
+short NamenodeStandin::Ioctl(ByteBuffer &request, ByteBuffer &response) {
+  unsigned char op = request.GetByte();
+  vector<int> components;
+  int length = ReadFilename(request, components);
+
+  long long count = 0;
+  short error = kErrOk;
+  if (op == kIoctlCountFiles) {
+    shared_ptr<Node> node = Resolve(components, length);
+    if (!node) {
+      error = kErrGetFileFailed;
+    } else {
+      count = node->children.size();
+    }
+  } else {
+    error = kErrProtocolMismatch;
+  }
+
+  response.PutByte(op);
+  response.PutLong(count);
+  return error;
+}
+
+int NamenodeStandin::ReadFilename(ByteBuffer &buf, vector<int> &components) {
+  int length = buf.GetInt();
+  components.assign(kDirectoryDepth, 0);
+  if (version_ >= kProtocolCompactFilename) {
+    if (length < 0 || length > kDirectoryDepth) {
+      return -1;
+    }
+    for (int i = 0; i < length; i++) {
+      components[i] = buf.GetInt();
+    }
+    return length;
+  }
+  for (int i = 0; i < kDirectoryDepth; i++) {
+    components[i] = buf.GetInt();
+  }
+  if (length < 0 || length > kDirectoryDepth) {
+    return -1;
+  }
+  return length;
+}
+
+shared_ptr<NamenodeStandin::Node>
+NamenodeStandin::Resolve(const vector<int> &components, int depth) {
+  if (depth < 0) {
+    return nullptr;
+  }
+  shared_ptr<Node> node = root_;
+  for (int i = 0; i < depth && node; i++) {
+    auto iter = node->children.find(components[i]);
+    node = iter != node->children.end() ? iter->second : nullptr;
+  }
+  return node;
+}
+
+bool NamenodeStandin::AllocateBlock(Node &node, size_t index) {
+  if (index < node.blocks.size() && node.blocks[index].datanode >= 0) {
+    return true;
+  }
+
+  for (size_t i = 0; i < datanodes_.size(); i++) {
+    int candidate = (round_robin_ + i) % datanodes_.size();
+    Datanode &datanode = datanodes_[candidate];
+    if (datanode.storage_class != node.storage_class) {
+      continue;
+    }
+
+    long long addr = -1;
+    if (!datanode.free.empty()) {
+      addr = datanode.free.back();
+      datanode.free.pop_back();
+    } else if (datanode.next + kBlockSize <= datanode.size) {
+      addr = datanode.next;
+      datanode.next += kBlockSize;
+    } else {
+      continue;
+    }
+
+    if (index >= node.blocks.size()) {
+      node.blocks.resize(index + 1, Block{-1, 0});
+    }
+    node.blocks[index].datanode = candidate;
+    node.blocks[index].addr = addr;
+    round_robin_ = candidate + 1;
+    return true;
+  }
+  return false;
+}
+
+void NamenodeStandin::ReleaseBlocks(Node &node) {
+  for (auto &child : node.children) {
+    ReleaseBlocks(*child.second);
+  }
+  node.children.clear();
+  for (Block &block : node.blocks) {
+    if (block.datanode >= 0) {
+      datanodes_[block.datanode].free.push_back(block.addr);
+    }
+  }
+  node.blocks.clear();
+  fd_table_.erase(node.fd);
+}
+
+void NamenodeStandin::WriteFileInfo(ByteBuffer &buf, const Node *node,
+                                    bool ship_token) {
+  if (!node) {
+    buf.PutLong(0);
+    buf.PutLong(0);
+    buf.PutInt(0);
+    buf.PutLong(0);
+    buf.PutLong(0);
+    buf.PutLong(0);
+    return;
+  }
+  buf.PutLong(node->fd);
+  buf.PutLong(node->capacity);
+  buf.PutInt(node->type);
+  buf.PutLong(node->dir_offset);
+  buf.PutLong(ship_token ? node->token : 0);
+  buf.PutLong(node->modification_time);
+}
+
+void NamenodeStandin::WriteBlockInfo(ByteBuffer &buf, const Node *node,
+                                     int index) {
+  const Block *block = nullptr;
+  if (node && index >= 0 && (size_t)index < node->blocks.size() &&
+      node->blocks[index].datanode >= 0) {
+    block = &node->blocks[index];
+  }
+  if (!block) {
+    for (int i = 0; i < 5; i++) {
+      buf.PutInt(0);
+    }
+    buf.PutLong(0);
+    buf.PutLong(0);
+    buf.PutInt(0);
+    buf.PutInt(0);
+    return;
+  }
+
+  const Datanode &datanode = datanodes_[block->datanode];
+  buf.PutInt(0);
+  buf.PutInt(datanode.storage_class);
+  buf.PutInt(0);
+  buf.PutBytes((char *)&datanode.address, 4);
+  buf.PutInt(datanode.port);
+  buf.PutLong(block->addr / 512);
+  buf.PutLong(block->addr);
+  buf.PutInt(kBlockSize);
+  buf.PutInt(0);
+}
@@ -0,0 +1,111 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NAMENODE_STANDIN_H
+#define NAMENODE_STANDIN_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/byte_buffer.h"
+#include "standin_server.h"
+
+using namespace std;
+
+namespace crail {
+
+// In-memory namenode speaking the NaRPC metadata protocol used by
+// NamenodeClient. Blocks are handed out round-robin from the registered
+// datanodes of the requested storage class.
+class NamenodeStandin : public StandinServer {
+public:
+  NamenodeStandin();
+  virtual ~NamenodeStandin();
+
+  int AddDatanode(int address, int port, int storage_class, long long size);
+
+protected:
+  void Serve(int socket);
+
+private:
+  struct Block {
+    int datanode;
+    long long addr;
+  };
+
+  struct Datanode {
+    int address;
+    int port;
+    int storage_class;
+    long long next;
+    long long size;
+    vector<long long> free;
+  };
+
+  struct Node {
+    long long fd;
+    int type;
+    long long capacity;
+    long long dir_offset;
+    long long token;
+    long long modification_time;
+    int storage_class;
+    long long next_dir_offset;
+    unordered_map<int, shared_ptr<Node>> children;
+    vector<Block> blocks;
+  };
+
+  int Process(ByteBuffer &request, ByteBuffer &response);
+
+  short Create(ByteBuffer &request, ByteBuffer &response);
+  short Lookup(ByteBuffer &request, ByteBuffer &response);
+  short SetFile(ByteBuffer &request, ByteBuffer &response);
+  short Remove(ByteBuffer &request, ByteBuffer &response);
+  short GetBlock(ByteBuffer &request, ByteBuffer &response);
+  short GetBlockRange(ByteBuffer &request, ByteBuffer &response);
+  short Ping(ByteBuffer &request, ByteBuffer &response);
+  short Ioctl(ByteBuffer &request, ByteBuffer &response);
+
+  int ReadFilename(ByteBuffer &buf, vector<int> &components);
+  shared_ptr<Node> Resolve(const vector<int> &components, int depth);
+  bool AllocateBlock(Node &node, size_t index);
+  void ReleaseBlocks(Node &node);
+
+  void WriteFileInfo(ByteBuffer &buf, const Node *node, bool ship_token);
+  void WriteBlockInfo(ByteBuffer &buf, const Node *node, int index);
+
+  mutex lock_;
+  // protocol version of the request being processed
+  short version_;
+  shared_ptr<Node> root_;
+  unordered_map<long long, shared_ptr<Node>> fd_table_;
+  vector<Datanode> datanodes_;
+  long long fd_counter_;
+  long long token_counter_;
+  unsigned long long round_robin_;
+};
+} // namespace crail
+
+#endif /* NAMENODE_STANDIN_H */
@@ -0,0 +1,88 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reflex_standin.h"
+
+#include <string.h>
+
+#include "common/byte_buffer.h"
+#include "common/crail_constants.h"
+#include "reflex/reflex_client.h"
+#include "reflex/reflex_header.h"
+
+using namespace std;
+using namespace crail;
+
+ReflexStandin::ReflexStandin(long long capacity)
+    : capacity_(capacity), memory_(new unsigned char[capacity]) {}
+
+ReflexStandin::~ReflexStandin() {}
+
+void ReflexStandin::Serve(int socket) {
+  ReflexHeader header;
+  ByteBuffer buf(header.Size());
+  buf.set_order(ByteOrder::LittleEndian);
+  unique_ptr<unsigned char[]> scratch(new unsigned char[kBlockSize]);
+
+  while (true) {
+    buf.Clear();
+    if (RecvBytes(socket, buf.get_bytes(), header.Size()) < 0) {
+      return;
+    }
+    header.Update(buf);
+    // ReflexHeader has no lba accessor, magic and type precede the lba
+    buf.set_position(sizeof(short) * 2 + sizeof(long long));
+    long long lba = buf.GetLong();
+
+    long long offset = lba * kReflexBlockSize;
+    int length = header.count() * kReflexBlockSize;
+    if (length < 0 || length > kBlockSize) {
+      return;
+    }
+    bool valid = offset >= 0 && offset + length <= capacity_;
+
+    if (header.type() == kCmdPut) {
+      unsigned char *dst = valid ? memory_.get() + offset : scratch.get();
+      if (RecvBytes(socket, dst, length) < 0) {
+        return;
+      }
+    }
+
+    buf.Clear();
+    buf.set_limit(header.Size());
+    if (SendBytes(socket, buf.get_bytes(), buf.remaining()) < 0) {
+      return;
+    }
+
+    if (header.type() == kCmdGet) {
+      unsigned char *src = memory_.get() + offset;
+      if (!valid) {
+        memset(scratch.get(), 0, length);
+        src = scratch.get();
+      }
+      if (SendBytes(socket, src, length) < 0) {
+        return;
+      }
+    }
+  }
+}
@@ -0,0 +1,94 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "standin_cluster.h"
+
+using namespace std;
+using namespace crail;
+
+struct Settings {
+  string address;
+  int namenode_port;
+  vector<int> datanode_ports;
+  vector<int> reflex_ports;
+  long long datanode_size;
+};
+
+void usage() {
+  cout << "pocket-standin -n <namenode port> [-d <datanode port>]... "
+          "[-r <reflex port>]... [-a <address>] [-m <datanode MB>]"
+       << endl;
+}
+
+int main(int argc, char *argv[]) {
+  Settings settings;
+  settings.address = "127.0.0.1";
+  settings.namenode_port = 9060;
+  settings.datanode_size = 256;
+
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "n:d:r:a:m:h")) != -1) {
+    switch (opt) {
+    case 'n':
+      settings.namenode_port = atoi(optarg);
+      break;
+    case 'd':
+      settings.datanode_ports.push_back(atoi(optarg));
+      break;
+    case 'r':
+      settings.reflex_ports.push_back(atoi(optarg));
+      break;
+    case 'a':
+      settings.address = optarg;
+      break;
+    case 'm':
+      settings.datanode_size = atoll(optarg);
+      break;
+    default:
+      usage();
+      return -1;
+    }
+  }
+  if (settings.datanode_ports.empty() && settings.reflex_ports.empty()) {
+    settings.datanode_ports.push_back(settings.namenode_port + 1);
+  }
+
+  StandinCluster cluster;
+  if (cluster.Start(settings.address, settings.namenode_port,
+                    settings.datanode_ports, settings.reflex_ports,
+                    settings.datanode_size * 1024 * 1024) < 0) {
+    return -1;
+  }
+  cout << "namenode listening on port " << cluster.namenode_port() << endl;
+
+  while (true) {
+    pause();
+  }
+  return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "standin_cluster.h"
+
+#include <arpa/inet.h>
+#include <iostream>
+
+#include "datanode_standin.h"
+#include "reflex_standin.h"
+
+using namespace std;
+using namespace crail;
+
+StandinCluster::StandinCluster() {}
+
+StandinCluster::~StandinCluster() { Stop(); }
+
+int StandinCluster::Start(string address, int namenode_port,
+                          vector<int> &datanode_ports,
+                          vector<int> &reflex_ports,
+                          long long datanode_size) {
+  int addr = (int)inet_addr(address.c_str());
+
+  for (int port : datanode_ports) {
+    unique_ptr<DatanodeStandin> datanode(new DatanodeStandin(datanode_size));
+    if (datanode->Listen(port) < 0 || datanode->Start() < 0) {
+      cout << "cannot start datanode stand-in on port " << port << endl;
+      return -1;
+    }
+    namenode_.AddDatanode(addr, datanode->port(), 0, datanode_size);
+    servers_.push_back(move(datanode));
+  }
+  for (int port : reflex_ports) {
+    unique_ptr<ReflexStandin> reflex(new ReflexStandin(datanode_size));
+    if (reflex->Listen(port) < 0 || reflex->Start() < 0) {
+      cout << "cannot start reflex stand-in on port " << port << endl;
+      return -1;
+    }
+    namenode_.AddDatanode(addr, reflex->port(), 1, datanode_size);
+    servers_.push_back(move(reflex));
+  }
+
+  if (namenode_.Listen(namenode_port) < 0 || namenode_.Start() < 0) {
+    cout << "cannot start namenode stand-in on port " << namenode_port
+         << endl;
+    return -1;
+  }
+  return 0;
+}
+
+void StandinCluster::Stop() {
+  namenode_.Stop();
+  for (unique_ptr<StandinServer> &server : servers_) {
+    server->Stop();
+  }
+}
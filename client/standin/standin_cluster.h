@@ -0,0 +1,57 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STANDIN_CLUSTER_H
+#define STANDIN_CLUSTER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "namenode_standin.h"
+#include "standin_server.h"
+
+using namespace std;
+
+namespace crail {
+
+// Namenode plus DRAM datanodes and ReFlex servers on one host, all running
+// in the calling process. Port 0 picks a free port.
+class StandinCluster {
+public:
+  StandinCluster();
+  virtual ~StandinCluster();
+
+  int Start(string address, int namenode_port, vector<int> &datanode_ports,
+            vector<int> &reflex_ports, long long datanode_size);
+  void Stop();
+
+  int namenode_port() const { return namenode_.port(); }
+
+private:
+  NamenodeStandin namenode_;
+  vector<unique_ptr<StandinServer>> servers_;
+};
+} // namespace crail
+
+#endif /* STANDIN_CLUSTER_H */
@@ -0,0 +1,129 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "standin_server.h"
+
+#include <arpa/inet.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace crail;
+
+StandinServer::StandinServer() : socket_(-1), port_(-1), running_(false) {}
+
+StandinServer::~StandinServer() { Stop(); }
+
+int StandinServer::Listen(int port) {
+  socket_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (socket_ < 0) {
+    perror("cannot create socket");
+    return -1;
+  }
+  int yes = 1;
+  setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, (char *)&yes, sizeof(int));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(socket_, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    perror("cannot bind socket");
+    return -1;
+  }
+  if (listen(socket_, 128) < 0) {
+    perror("cannot listen on socket");
+    return -1;
+  }
+
+  socklen_t len = sizeof(addr);
+  getsockname(socket_, (struct sockaddr *)&addr, &len);
+  port_ = ntohs(addr.sin_port);
+  return 0;
+}
+
+int StandinServer::Start() {
+  if (socket_ < 0) {
+    return -1;
+  }
+  running_ = true;
+  acceptor_ = thread(&StandinServer::Run, this);
+  return 0;
+}
+
+void StandinServer::Stop() {
+  if (!running_) {
+    return;
+  }
+  running_ = false;
+  shutdown(socket_, SHUT_RDWR);
+  close(socket_);
+  if (acceptor_.joinable()) {
+    acceptor_.join();
+  }
+}
+
+void StandinServer::Run() {
+  while (running_) {
+    int client = accept(socket_, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+    int yes = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (char *)&yes, sizeof(int));
+    thread([this, client]() {
+      Serve(client);
+      close(client);
+    }).detach();
+  }
+}
+
+int StandinServer::SendBytes(int socket, const unsigned char *buf,
+                             int size) {
+  int sum = 0;
+  while (sum < size) {
+    int res = send(socket, buf + sum, (size_t)(size - sum), MSG_NOSIGNAL);
+    if (res <= 0) {
+      return -1;
+    }
+    sum += res;
+  }
+  return 0;
+}
+
+int StandinServer::RecvBytes(int socket, unsigned char *buf, int size) {
+  int sum = 0;
+  while (sum < size) {
+    int res = recv(socket, buf + sum, (size_t)(size - sum), 0);
+    if (res <= 0) {
+      return -1;
+    }
+    sum += res;
+  }
+  return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * CppCrail: Native Crail
+ *
+ * Author: Patrick Stuedi  <stu@zurich.ibm.com>
+ *
+ * Copyright (C) 2015-2018, IBM Corporation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STANDIN_SERVER_H
+#define STANDIN_SERVER_H
+
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+namespace crail {
+
+// Minimal blocking TCP server used by the stand-in services, one thread per
+// accepted connection.
+class StandinServer {
+public:
+  StandinServer();
+  virtual ~StandinServer();
+
+  int Listen(int port);
+  int Start();
+  void Stop();
+
+  int port() const { return port_; }
+
+protected:
+  virtual void Serve(int socket) = 0;
+
+  static int SendBytes(int socket, const unsigned char *buf, int size);
+  static int RecvBytes(int socket, unsigned char *buf, int size);
+
+private:
+  void Run();
+
+  int socket_;
+  int port_;
+  atomic<bool> running_;
+  thread acceptor_;
+};
+} // namespace crail
+
+#endif /* STANDIN_SERVER_H */
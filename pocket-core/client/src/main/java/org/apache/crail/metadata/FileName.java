@@ -79,6 +79,29 @@ public class FileName {
 		}
 	}	
 
+	//compact encoding, only the used components follow the length
+	public int writeCompact(ByteBuffer buffer) {
+		buffer.putInt(length);
+		for (int i = 0; i < length; i++){
+			buffer.putInt(components[i]);
+		}
+		return sizeCompact();
+	}
+	
+	public void updateCompact(ByteBuffer buffer) throws IOException {
+		int _length = buffer.getInt();
+		if (_length < 0 || _length > components.length){
+			throw new IOException("compact filename with invalid length " + _length);
+		}
+		this.length = _length;
+		for (int i = 0; i < length; i++){
+			components[i] = buffer.getInt();
+		}
+		for (int i = length; i < components.length; i++){
+			components[i] = 0;
+		}
+	}
+
 	public int getFileComponent(){
 		return getComponent(length - 1);
 	}	
@@ -99,6 +122,10 @@ public class FileName {
 	public int size(){
 		return CSIZE;
 	}
+	
+	public int sizeCompact(){
+		return 4 + length*4;
+	}
 
 	@Override
 	public boolean equals(Object obj) {
@@ -21,6 +21,7 @@ package org.apache.crail.namenode;
 import org.apache.crail.rpc.*;
 import org.apache.crail.rpc.RpcRequestMessage.CreateFileReq;
 import org.apache.crail.rpc.RpcRequestMessage.DumpNameNodeReq;
+import org.apache.crail.rpc.RpcRequestMessage.GetBlockRangeReq;
 import org.apache.crail.rpc.RpcRequestMessage.GetBlockReq;
 import org.apache.crail.rpc.RpcRequestMessage.GetDataNodeReq;
 import org.apache.crail.rpc.RpcRequestMessage.GetFileReq;
@@ -32,6 +33,7 @@ import org.apache.crail.rpc.RpcRequestMessage.SetBlockReq;
 import org.apache.crail.rpc.RpcRequestMessage.SetFileReq;
 import org.apache.crail.rpc.RpcResponseMessage.CreateFileRes;
 import org.apache.crail.rpc.RpcResponseMessage.DeleteFileRes;
+import org.apache.crail.rpc.RpcResponseMessage.GetBlockRangeRes;
 import org.apache.crail.rpc.RpcResponseMessage.GetBlockRes;
 import org.apache.crail.rpc.RpcResponseMessage.GetDataNodeRes;
 import org.apache.crail.rpc.RpcResponseMessage.GetFileRes;
@@ -117,6 +119,12 @@ public class LogDispatcher implements RpcNameNodeService {
 		return service.getBlock(request, response, errorState);
 	}
 
+	@Override
+	public short getBlockRange(GetBlockRangeReq request, GetBlockRangeRes response,
+			RpcNameNodeState errorState) throws Exception {
+		return service.getBlockRange(request, response, errorState);
+	}
+
 	@Override
 	public short getLocation(GetLocationReq request, GetLocationRes response,
 			RpcNameNodeState errorState) throws Exception {
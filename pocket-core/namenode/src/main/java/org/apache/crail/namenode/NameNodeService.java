@@ -526,6 +526,46 @@ public class NameNodeService implements RpcNameNodeService, Sequencer {
 		return RpcErrors.ERR_OK;
 	}
 	
+	@Override
+	public short getBlockRange(RpcRequestMessage.GetBlockRangeReq request, RpcResponseMessage.GetBlockRangeRes response, RpcNameNodeState errorState) throws Exception {
+		//check protocol
+		if (!RpcProtocol.verifyProtocol(RpcProtocol.CMD_GET_BLOCK_RANGE, request, response)){
+			return RpcErrors.ERR_PROTOCOL_MISMATCH;
+		}			
+		
+		//get params
+		long fd = request.getFd();
+		long position = request.getPosition();
+		long length = request.getLength();
+		
+		//check params
+		if (position < 0 || length < 0){
+			return RpcErrors.ERR_POSITION_NEGATIV;
+		}
+	
+		//rpc
+		AbstractNode fileInfo = fileTable.get(fd);
+		if (fileInfo == null){
+			return RpcErrors.ERR_FILE_NOT_OPEN;			
+		}
+		
+		//read-only, blocks are never allocated here, the range ends at the first missing block
+		int index = CrailUtils.computeIndex(position);
+		int last = CrailUtils.computeIndex(position + Math.max(length, 1) - 1);
+		for (; index <= last; index++){
+			NameNodeBlockInfo block = fileInfo.getBlock(index);
+			if (block == null || !response.addBlockInfo(block)){
+				break;
+			}
+		}
+		
+		if (CrailConstants.DEBUG){
+			LOG.info("getBlockRange: fd " + fd + ", position " + position + ", length " + length + ", blocks " + response.getCount());
+		}
+		
+		return RpcErrors.ERR_OK;
+	}
+	
 	@Override
 	public short getLocation(RpcRequestMessage.GetLocationReq request, RpcResponseMessage.GetLocationRes response, RpcNameNodeState errorState) throws Exception {
 		//check protocol
@@ -587,7 +627,11 @@ public class NameNodeService implements RpcNameNodeService, Sequencer {
 			return RpcErrors.ERR_PROTOCOL_MISMATCH;
 		}	
 		
-		response.setData(request.getOp()+1);
+		if (request.getOp() == RpcProtocol.PING_PROTOCOL_PROBE){
+			response.setData(request.getOp() + 1 + RpcProtocol.VERSION);
+		} else {
+			response.setData(request.getOp()+1);
+		}
 		
 		return RpcErrors.ERR_OK;
 	}
@@ -40,6 +40,7 @@ public class TcpNameNodeRequest extends RpcRequestMessage implements NaRPCMessag
 	private RpcRequestMessage.RemoveFileReq removeReq;
 	private RpcRequestMessage.RenameFileReq renameFileReq;
 	private RpcRequestMessage.GetBlockReq getBlockReq;
+	private RpcRequestMessage.GetBlockRangeReq getBlockRangeReq;
 	private RpcRequestMessage.GetLocationReq getLocationReq;
 	private RpcRequestMessage.SetBlockReq setBlockReq;
 	private RpcRequestMessage.GetDataNodeReq getDataNodeReq;
@@ -56,6 +57,7 @@ public class TcpNameNodeRequest extends RpcRequestMessage implements NaRPCMessag
 		this.removeReq = new RpcRequestMessage.RemoveFileReq();
 		this.renameFileReq = new RpcRequestMessage.RenameFileReq();
 		this.getBlockReq = new RpcRequestMessage.GetBlockReq();
+		this.getBlockRangeReq = new RpcRequestMessage.GetBlockRangeReq();
 		this.getLocationReq = new RpcRequestMessage.GetLocationReq();
 		this.setBlockReq = new RpcRequestMessage.SetBlockReq();
 		this.dumpNameNodeReq = new RpcRequestMessage.DumpNameNodeReq();
@@ -93,6 +95,11 @@ public class TcpNameNodeRequest extends RpcRequestMessage implements NaRPCMessag
 		this.getBlockReq = message;
 	}
 	
+	public TcpNameNodeRequest(RpcRequestMessage.GetBlockRangeReq message) {
+		this.type = message.getType();
+		this.getBlockRangeReq = message;
+	}
+	
 	public TcpNameNodeRequest(RpcRequestMessage.GetLocationReq message) {
 		this.type = message.getType();
 		this.getLocationReq = message;
@@ -155,6 +162,9 @@ public class TcpNameNodeRequest extends RpcRequestMessage implements NaRPCMessag
 		case RpcProtocol.REQ_GET_BLOCK:
 			written += getBlockReq.write(buffer);
 			break;
+		case RpcProtocol.REQ_GET_BLOCK_RANGE:
+			written += getBlockRangeReq.write(buffer);
+			break;
 		case RpcProtocol.REQ_GET_LOCATION:
 			written += getLocationReq.write(buffer);
 			break;			
@@ -180,20 +190,22 @@ public class TcpNameNodeRequest extends RpcRequestMessage implements NaRPCMessag
 	
 	public void update(ByteBuffer buffer) throws IOException {
 		this.cmd = buffer.getShort();
-		this.type = buffer.getShort();
+		short header = buffer.getShort();
+		this.type = (short) (header & RpcProtocol.TYPE_MASK);
+		short version = (short) ((header & 0xffff) >> RpcProtocol.VERSION_SHIFT);
 		
 		switch(type){
 		case RpcProtocol.REQ_CREATE_FILE:
-			createFileReq.update(buffer);
+			createFileReq.update(buffer, version);
 			break;		
 		case RpcProtocol.REQ_GET_FILE:
-			fileReq.update(buffer);
+			fileReq.update(buffer, version);
 			break;
 		case RpcProtocol.REQ_SET_FILE:
 			setFileReq.update(buffer);
 			break;
 		case RpcProtocol.REQ_REMOVE_FILE:
-			removeReq.update(buffer);
+			removeReq.update(buffer, version);
 			break;			
 		case RpcProtocol.REQ_RENAME_FILE:
 			renameFileReq.update(buffer);
@@ -201,6 +213,9 @@ public class TcpNameNodeRequest extends RpcRequestMessage implements NaRPCMessag
 		case RpcProtocol.REQ_GET_BLOCK:
 			getBlockReq.update(buffer);
 			break;
+		case RpcProtocol.REQ_GET_BLOCK_RANGE:
+			getBlockRangeReq.update(buffer);
+			break;
 		case RpcProtocol.REQ_GET_LOCATION:
 			getLocationReq.update(buffer);
 			break;			
@@ -255,6 +270,10 @@ public class TcpNameNodeRequest extends RpcRequestMessage implements NaRPCMessag
 		return getBlockReq;
 	}
 	
+	public RpcRequestMessage.GetBlockRangeReq getBlockRange() {
+		return getBlockRangeReq;
+	}
+	
 	public RpcRequestMessage.GetLocationReq getLocation() {
 		return getLocationReq;
 	}	
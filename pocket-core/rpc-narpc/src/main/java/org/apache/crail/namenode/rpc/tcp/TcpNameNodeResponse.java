@@ -31,7 +31,7 @@ import com.ibm.narpc.NaRPCMessage;
 
 public class TcpNameNodeResponse extends RpcResponseMessage implements RpcNameNodeState, NaRPCMessage {
 	public static final Logger LOG = CrailUtils.getLogger();
-	public static final int CSIZE = 2*Short.BYTES + Math.max(RpcResponseMessage.GetBlockRes.CSIZE, RpcResponseMessage.RenameRes.CSIZE);
+	public static final int CSIZE = 2*Short.BYTES + Math.max(RpcResponseMessage.GetBlockRangeRes.CSIZE, Math.max(RpcResponseMessage.GetBlockRes.CSIZE, RpcResponseMessage.RenameRes.CSIZE));
 	
 	private short type;
 	private short error;
@@ -41,6 +41,7 @@ public class TcpNameNodeResponse extends RpcResponseMessage implements RpcNameNo
 	private RpcResponseMessage.DeleteFileRes delFileRes;
 	private RpcResponseMessage.RenameRes renameRes;
 	private RpcResponseMessage.GetBlockRes getBlockRes;
+	private RpcResponseMessage.GetBlockRangeRes getBlockRangeRes;
 	private RpcResponseMessage.GetLocationRes getLocationRes;	
 	private RpcResponseMessage.GetDataNodeRes getDataNodeRes;
 	private RpcResponseMessage.PingNameNodeRes pingNameNodeRes;
@@ -55,6 +56,7 @@ public class TcpNameNodeResponse extends RpcResponseMessage implements RpcNameNo
 		this.delFileRes = new RpcResponseMessage.DeleteFileRes();
 		this.renameRes = new RpcResponseMessage.RenameRes();
 		this.getBlockRes = new RpcResponseMessage.GetBlockRes();
+		this.getBlockRangeRes = new RpcResponseMessage.GetBlockRangeRes();
 		this.getLocationRes = new RpcResponseMessage.GetLocationRes();
 		this.getDataNodeRes = new RpcResponseMessage.GetDataNodeRes();
 		this.pingNameNodeRes = new RpcResponseMessage.PingNameNodeRes();
@@ -91,6 +93,11 @@ public class TcpNameNodeResponse extends RpcResponseMessage implements RpcNameNo
 		this.getBlockRes = message;
 	}
 	
+	public TcpNameNodeResponse(RpcResponseMessage.GetBlockRangeRes message) {
+		this.type = message.getType();
+		this.getBlockRangeRes = message;
+	}
+	
 	public TcpNameNodeResponse(RpcResponseMessage.GetLocationRes message) {
 		this.type = message.getType();
 		this.getLocationRes = message;
@@ -143,6 +150,9 @@ public class TcpNameNodeResponse extends RpcResponseMessage implements RpcNameNo
 		case RpcProtocol.RES_GET_BLOCK:
 			written += getBlockRes.write(buffer);
 			break;
+		case RpcProtocol.RES_GET_BLOCK_RANGE:
+			written += getBlockRangeRes.write(buffer);
+			break;
 		case RpcProtocol.RES_GET_LOCATION:
 			written += getLocationRes.write(buffer);
 			break;			
@@ -189,6 +199,10 @@ public class TcpNameNodeResponse extends RpcResponseMessage implements RpcNameNo
 			getBlockRes.update(buffer);
 			getBlockRes.setError(error);
 			break;
+		case RpcProtocol.RES_GET_BLOCK_RANGE:
+			getBlockRangeRes.update(buffer);
+			getBlockRangeRes.setError(error);
+			break;
 		case RpcProtocol.RES_GET_LOCATION:
 			getLocationRes.update(buffer);
 			getLocationRes.setError(error);
@@ -244,6 +258,10 @@ public class TcpNameNodeResponse extends RpcResponseMessage implements RpcNameNo
 		return getBlockRes;
 	}	
 	
+	public RpcResponseMessage.GetBlockRangeRes getBlockRange() {
+		return getBlockRangeRes;
+	}	
+	
 	public RpcResponseMessage.GetLocationRes getLocation() {
 		return getLocationRes;
 	}	
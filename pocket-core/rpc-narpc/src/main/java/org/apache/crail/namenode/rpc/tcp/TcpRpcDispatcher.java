@@ -68,6 +68,9 @@ public class TcpRpcDispatcher implements NaRPCService<TcpNameNodeRequest, TcpNam
 			case RpcProtocol.CMD_GET_BLOCK:
 				error = service.getBlock(request.getBlock(), response.getBlock(), response);
 				break;
+			case RpcProtocol.CMD_GET_BLOCK_RANGE:
+				error = service.getBlockRange(request.getBlockRange(), response.getBlockRange(), response);
+				break;
 			case RpcProtocol.CMD_GET_LOCATION:
 				error = service.getLocation(request.getLocation(), response.getLocation(), response);
 				break;				
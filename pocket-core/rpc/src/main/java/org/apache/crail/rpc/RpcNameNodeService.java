@@ -54,6 +54,10 @@ public interface RpcNameNodeService {
 			RpcResponseMessage.GetBlockRes response, RpcNameNodeState errorState)
 			throws Exception;
 
+	public abstract short getBlockRange(RpcRequestMessage.GetBlockRangeReq request,
+			RpcResponseMessage.GetBlockRangeRes response, RpcNameNodeState errorState)
+			throws Exception;
+
 	public abstract short getLocation(RpcRequestMessage.GetLocationReq request,
 			RpcResponseMessage.GetLocationRes response, RpcNameNodeState errorState)
 			throws Exception;
@@ -40,6 +40,7 @@ public class RpcProtocol extends RpcErrors {
 	public static final short CMD_PING_NAMENODE = 11;
 	public static final short CMD_GET_DATANODE = 12;
 	public static final short CMD_IOCTL_NAMENODE = 13;
+	public static final short CMD_GET_BLOCK_RANGE = 15;
 	
 	//request types
 	public static final short REQ_CREATE_FILE = 1;	
@@ -54,6 +55,7 @@ public class RpcProtocol extends RpcErrors {
 	public static final short REQ_PING_NAMENODE = 11;
 	public static final short REQ_GET_DATANODE = 12;
 	public static final short REQ_IOCTL_NAMENODE = 13;
+	public static final short REQ_GET_BLOCK_RANGE = 15;
 	
 	//response types
 	public static final short RES_VOID = 1;
@@ -66,6 +68,17 @@ public class RpcProtocol extends RpcErrors {
 	public static final short RES_PING_NAMENODE = 9;
 	public static final short RES_GET_DATANODE = 10;
 	public static final short RES_IOCTL_NAMENODE = 11;
+	public static final short RES_GET_BLOCK_RANGE = 12;
+	
+	//protocol versions, carried in the high byte of the request type
+	public static final short VERSION_LEGACY = 0;
+	public static final short VERSION_COMPACT_FILENAME = 1;
+	public static final short VERSION = VERSION_COMPACT_FILENAME;
+	public static final int TYPE_MASK = 0xff;
+	public static final int VERSION_SHIFT = 8;
+	
+	//a ping with this op is answered with op + 1 + VERSION, older servers reply op + 1
+	public static final int PING_PROTOCOL_PROBE = 0x50434b00;
 
 	static {
 		requestTypes[0] = 0;
@@ -81,6 +94,7 @@ public class RpcProtocol extends RpcErrors {
 		requestTypes[CMD_PING_NAMENODE] = REQ_PING_NAMENODE;	
 		requestTypes[CMD_GET_DATANODE] = REQ_GET_DATANODE;
 		requestTypes[CMD_IOCTL_NAMENODE] = REQ_IOCTL_NAMENODE;
+		requestTypes[CMD_GET_BLOCK_RANGE] = REQ_GET_BLOCK_RANGE;
 		
 		responseTypes[0] = 0;
 		responseTypes[CMD_CREATE_FILE] = RES_CREATE_FILE;
@@ -95,6 +109,7 @@ public class RpcProtocol extends RpcErrors {
 		responseTypes[CMD_PING_NAMENODE] = RES_PING_NAMENODE;	
 		responseTypes[CMD_GET_DATANODE] = RES_GET_DATANODE;
 		responseTypes[CMD_IOCTL_NAMENODE] = RES_IOCTL_NAMENODE;
+		responseTypes[CMD_GET_BLOCK_RANGE] = RES_GET_BLOCK_RANGE;
 	}
 	
 
@@ -92,8 +92,16 @@ public class RpcRequestMessage {
 			return CSIZE;
 		}		
 
-		public void update(ByteBuffer buffer) {
-			filename.update(buffer);
+		public void update(ByteBuffer buffer) throws IOException {
+			update(buffer, RpcProtocol.VERSION_LEGACY);
+		}
+		
+		public void update(ByteBuffer buffer, short version) throws IOException {
+			if (version >= RpcProtocol.VERSION_COMPACT_FILENAME){
+				filename.updateCompact(buffer);
+			} else {
+				filename.update(buffer);
+			}
 			int _type = buffer.getInt();
 			type = CrailNodeType.parse(_type);
 			storageClass = buffer.getInt();
@@ -149,8 +157,16 @@ public class RpcRequestMessage {
 			return CSIZE;
 		}		
 
-		public void update(ByteBuffer buffer) {
-			filename.update(buffer);
+		public void update(ByteBuffer buffer) throws IOException {
+			update(buffer, RpcProtocol.VERSION_LEGACY);
+		}
+		
+		public void update(ByteBuffer buffer, short version) throws IOException {
+			if (version >= RpcProtocol.VERSION_COMPACT_FILENAME){
+				filename.updateCompact(buffer);
+			} else {
+				filename.update(buffer);
+			}
 			int tmp = buffer.getInt();
 			writeable = (tmp == 1) ? true : false;
 		}		
@@ -250,8 +266,16 @@ public class RpcRequestMessage {
 			return CSIZE;
 		}		
 
-		public void update(ByteBuffer buffer) {
-			filename.update(buffer);
+		public void update(ByteBuffer buffer) throws IOException {
+			update(buffer, RpcProtocol.VERSION_LEGACY);
+		}
+		
+		public void update(ByteBuffer buffer, short version) throws IOException {
+			if (version >= RpcProtocol.VERSION_COMPACT_FILENAME){
+				filename.updateCompact(buffer);
+			} else {
+				filename.update(buffer);
+			}
 			int tmp = buffer.getInt();
 			recursive = (tmp == 1) ? true : false;
 		}		
@@ -381,6 +405,74 @@ public class RpcRequestMessage {
 		}		
 	}
 	
+	public static class GetBlockRangeReq implements RpcProtocol.NameNodeRpcMessage {
+		public static int CSIZE = 32;
+		
+		protected long fd;
+		protected long token;
+		protected long position;
+		protected long length;
+
+		public GetBlockRangeReq(){
+			this.fd = 0;
+			this.token = 0;
+			this.position = 0;
+			this.length = 0;	
+		}
+		
+		public GetBlockRangeReq(long fd, long token, long position, long length) {
+			this.fd = fd;
+			this.token = token;
+			this.position = position;
+			this.length = length;
+		}
+
+		public long getFd() {
+			return fd;
+		}
+
+		public long getPosition(){
+			return this.position;
+		}
+
+		public long getToken() {
+			return token;
+		}
+		
+		public long getLength(){
+			return length;
+		}
+		
+		public int size() {
+			return CSIZE;
+		}
+		
+		public short getType(){
+			return RpcProtocol.REQ_GET_BLOCK_RANGE;
+		}		
+		
+		public int write(ByteBuffer buffer) {
+			buffer.putLong(fd);
+			buffer.putLong(token);
+			buffer.putLong(position);
+			buffer.putLong(length);
+			return CSIZE;
+		}		
+
+		public void update(ByteBuffer buffer) {
+			fd = buffer.getLong();
+			token = buffer.getLong();
+			position = buffer.getLong();
+			length = buffer.getLong();
+		}
+
+		@Override
+		public String toString() {
+			return "GetBlockRangeReq [fd=" + fd + ", token=" + token + ", position="
+					+ position + ", length=" + length + "]";
+		}
+	}
+	
 	public static class GetLocationReq implements RpcProtocol.NameNodeRpcMessage {
 		public static int CSIZE = FileName.CSIZE + 8;
 		
@@ -489,6 +489,77 @@ public class RpcResponseMessage {
 
 	}	
 	
+	public static class GetBlockRangeRes implements RpcProtocol.NameNodeRpcMessage {
+		public static int MAX_BLOCKS = 8;
+		public static int CSIZE = 4 + BlockInfo.CSIZE*MAX_BLOCKS;
+		
+		private int count;
+		private BlockInfo[] blockInfos;
+		private short error;
+		
+		public GetBlockRangeRes() {
+			this.count = 0;
+			this.blockInfos = new BlockInfo[MAX_BLOCKS];
+			for (int i = 0; i < MAX_BLOCKS; i++){
+				this.blockInfos[i] = new BlockInfo();
+			}
+			this.error = 0;
+		}
+		
+		public int size() {
+			return 4 + BlockInfo.CSIZE*count;
+		}
+		
+		public short getType(){
+			return RpcProtocol.RES_GET_BLOCK_RANGE;
+		}
+		
+		public int write(ByteBuffer buffer) {
+			buffer.putInt(count);
+			int written = 4;
+			for (int i = 0; i < count; i++){
+				written += blockInfos[i].write(buffer);
+			}
+			return written;
+		}		
+
+		public void update(ByteBuffer buffer) {
+			count = buffer.getInt();
+			try {
+				for (int i = 0; i < count; i++){
+					blockInfos[i].update(buffer);
+				}
+			} catch (UnknownHostException e) {
+				e.printStackTrace();
+			}
+		}
+		
+		public int getCount(){
+			return count;
+		}
+
+		public BlockInfo getBlockInfo(int index) {
+			return blockInfos[index];
+		}
+
+		public boolean addBlockInfo(BlockInfo blockInfo) {
+			if (count >= MAX_BLOCKS){
+				return false;
+			}
+			this.blockInfos[count].setBlockInfo(blockInfo);
+			count++;
+			return true;
+		}
+		
+		public short getError(){
+			return error;
+		}
+
+		public void setError(short error) {
+			this.error = error;
+		}
+	}
+	
 	public static class GetLocationRes implements RpcProtocol.NameNodeRpcMessage, RpcGetLocation {
 		public static int CSIZE = BlockInfo.CSIZE + 8;
 		